@@ -1,5 +1,7 @@
 #include "buttons.h"
 #include "display.h"
+#include "inputEvents.h"
+#include "inputSnapshot.h"
 #include "xil_io.h"
 #include "xparameters.h"
 
@@ -54,16 +56,20 @@ int32_t buttons_read() {
 void buttons_runTest() {
 
   buttons_init();                    // initialize the buttons
+  inputEvents_init(); // with events on, the loop below sleeps until a button changes
+  inputSnapshot_init();
   display_fillScreen(DISPLAY_BLACK); // clear the screen
 
   while (1) { // run the function until all four buttons are pressed
-    if ((buttons_read() & ALL_ON) ==
+    inputSnapshot_update(); // one debounced read for every test below
+    uint8_t value = INPUTSNAPSHOT_GET_BUTTONS(inputSnapshot_getHeld());
+    if ((value & ALL_ON) ==
         ALL_ON) { // check if all four buttons are pressed
       display_fillScreen(DISPLAY_BLACK); // clear the screen
       break; // return from function if all four buttons are pressed
     }
 
-    if ((buttons_read() & BUTTONS_BTN0_MASK) ==
+    if ((value & BUTTONS_BTN0_MASK) ==
         BUTTONS_BTN0_MASK) { // check if button 0 is pressed
       display_fillRect((DISPLAY_WIDTH - RECT_WIDTH), Y_START, RECT_WIDTH,
                        RECT_HEIGHT,
@@ -79,7 +85,7 @@ void buttons_runTest() {
                        RECT_HEIGHT,
                        DISPLAY_BLACK); // erase first square on the LCD
 
-    if ((buttons_read() & BUTTONS_BTN1_MASK) ==
+    if ((value & BUTTONS_BTN1_MASK) ==
         BUTTONS_BTN1_MASK) { // check if button 1 is pressed
       display_fillRect(X_MIDDLE, Y_START, RECT_WIDTH, RECT_HEIGHT,
                        DISPLAY_GREEN); // show second square on LCD
@@ -93,7 +99,7 @@ void buttons_runTest() {
       display_fillRect(X_MIDDLE, Y_START, RECT_WIDTH, RECT_HEIGHT,
                        DISPLAY_BLACK); // erase second square on the LCD
 
-    if ((buttons_read() & BUTTONS_BTN2_MASK) ==
+    if ((value & BUTTONS_BTN2_MASK) ==
         BUTTONS_BTN2_MASK) { // check if button 2 is pressed
       display_fillRect(RECT_WIDTH, Y_START, RECT_WIDTH, RECT_HEIGHT,
                        DISPLAY_RED); // show third sqaure on LCD
@@ -107,7 +113,7 @@ void buttons_runTest() {
       display_fillRect(RECT_WIDTH, Y_START, RECT_WIDTH, RECT_HEIGHT,
                        DISPLAY_BLACK); // erase third square on LCD
 
-    if ((buttons_read() & BUTTONS_BTN3_MASK) ==
+    if ((value & BUTTONS_BTN3_MASK) ==
         BUTTONS_BTN3_MASK) { // check if button 3 is pressed
       display_fillRect(X_START, Y_START, RECT_WIDTH, RECT_HEIGHT,
                        DISPLAY_BLUE); // show fourth squre on LCD
@@ -120,6 +126,8 @@ void buttons_runTest() {
     } else
       display_fillRect(X_START, Y_START, RECT_WIDTH, RECT_HEIGHT,
                        DISPLAY_BLACK); // erase fourth square on the LCD
+
+    inputSnapshot_wait(); // redraw only when something could have changed
   }
 
   return;
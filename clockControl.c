@@ -1,84 +1,181 @@
 #include "clockControl.h"
+#include "clockDisplay.h"
+#include "clockSync.h"
+#include "fsm.h"
+#include "intervalTimer.h"
+#include "profiler.h"
+#include "tickMonitor.h"
+#include "touchInput.h"
 
 #include <display.h>
+#include <stdio.h>
 
-#define ADC_COUNTER_MAX_VALUE 5 // this value should be 40 or 50ms divided by the period of the tick function, currently assuming 10ms period
+#define AUTO_COUNTER_MAX_VALUE 50 // hold for 500ms before auto-repeat starts
+#define RATE_COUNTER_START_VALUE 50 // first repeats come every 500ms (2 Hz)
+#define RATE_COUNTER_MIN_VALUE 5 // repeats speed up to every 50ms (20 Hz)
+#define RATE_SPEEDUP_NUMERATOR 3 // each repeat shortens the period to 3/4 of the last one
+#define RATE_SPEEDUP_DENOMINATOR 4
+#define DISPLAY_REFRESH_MAX_VALUE 10 // while held, redraw at most every 100ms no matter how fast the time changes
+#define CLOCK_TIMER INTERVAL_TIMER_TIMER_0 // free-running time base for the clock
+#define TICK_PERIOD_INTERRUPTS 1 // ticked on every 10 ms timer interrupt
+#define TRACE_TRANSITIONS false // set to true to print every state transition
 
 // States of the clockControl state machine
 enum clockControl_st_t {
 	init_st,                 // Start here, transition out of this state on the first tick.
 	//never_touched_st,        // Wait here until the first touch - clock is disabled until set.
 	waiting_for_touch_st,    // waiting for touch, clock is enabled and running.
-	adc_counter_running_st,     // waiting for the touch-controller ADC to settle.
+	adc_counter_running_st,     // waiting for the touch input to settle on a point.
 	auto_counter_running_st,   // waiting for the auto-update delay to expire
-	rate_counter_running_st,   // waiting for the rate-timer to expire to know when to perform the auto inc/dec.
-	rate_counter_expired_st,   // when the rate-timer expires, perform the inc/dec function.
-	add_second_to_clock_st   // add a second to the clock time and reset the ms counter.
+	rate_counter_running_st    // waiting for the rate-timer to expire, then perform the auto inc/dec and start it again.
 };
 
-static enum clockControl_st_t currentState;
+static fsm_t fsm;
+
+// state names for the tick monitor and the transition trace, in enum order
+static const char *const stateNames[] = {"init_st", "waiting_for_touch_st", "adc_counter_running_st", "auto_counter_running_st", "rate_counter_running_st"};
+static uint8_t monitorId = TICKMONITOR_NO_MACHINE;
+
+static uint8_t autoCounter = 0;
+static uint8_t rateCounter = 0;
+static uint8_t ratePeriod = RATE_COUNTER_START_VALUE; // shrinks while the touch is held
+static uint8_t refreshCounter = 0;
+
+// transitions out of the states with more than one, indices into their rows below
+enum {ADC_HELD, ADC_TAP, ADC_ABANDONED};
+enum {AUTO_RELEASED, AUTO_EXPIRED};
+enum {RATE_RELEASED, RATE_EXPIRED};
+
+// transition selection, one function per state that can stay
+
+// helper function that leaves waiting_for_touch_st on a touch
+static uint8_t waitingForTouchSelect() {
+    return touchInput_isTouched() ? 0 : FSM_STAY;
+}
+
+// helper function that waits for the touch to settle, or to be let go without a usable reading
+static uint8_t adcCounterRunningSelect() {
+    if (touchInput_isSettled())
+        return touchInput_isTouched() ? ADC_HELD : ADC_TAP; // settled after it let go - a tap
+    return touchInput_isAbandoned() ? ADC_ABANDONED : FSM_STAY;
+}
+
+// helper function that waits for a release or for the touch to be held long enough to auto-repeat
+static uint8_t autoCounterRunningSelect() {
+    if (!touchInput_isTouched())
+        return AUTO_RELEASED;
+    return (autoCounter == AUTO_COUNTER_MAX_VALUE) ? AUTO_EXPIRED : FSM_STAY;
+}
+
+// helper function that waits for a release or for the next auto-repeat step to come due
+static uint8_t rateCounterRunningSelect() {
+    if (!touchInput_isTouched())
+        return RATE_RELEASED;
+    return (rateCounter >= ratePeriod) ? RATE_EXPIRED : FSM_STAY;
+}
+
+// transition actions
+
+// helper function that shows the final time
+static void showTime() {
+    clockDisplay_updateTimeDisplay(false);
+}
+
+// helper function that takes one step and shows it
+static void stepAndShow() {
+    clockDisplay_performIncDec();
+    clockDisplay_updateTimeDisplay(false);
+}
+
+// helper function that takes the first auto-repeat step at the slowest rate
+static void startRepeating() {
+    ratePeriod = RATE_COUNTER_START_VALUE;
+    clockDisplay_performIncDec();
+}
+
+// helper function that takes an auto-repeat step, restarts the count and shortens the period to the next one
+static void repeatStep() {
+    clockDisplay_performIncDec(); // the time changes now, the display catches up on the next refresh
+    rateCounter = 0; // in the same transition, so a step comes every ratePeriod ticks, not one more
+    ratePeriod = ratePeriod * RATE_SPEEDUP_NUMERATOR / RATE_SPEEDUP_DENOMINATOR;
+    if (ratePeriod < RATE_COUNTER_MIN_VALUE)
+        ratePeriod = RATE_COUNTER_MIN_VALUE;
+}
+
+// state actions
+
+// helper function that keeps the clock running while nothing is touched
+static void waitingForTouchTick() {
+    autoCounter = 0;
+    clockSync_update(); // catch the display up to the hardware timer, usually nothing to do
+}
+
+// helper function that counts the hold time before auto-repeat starts
+static void autoCounterRunningTick() {
+    autoCounter++;
+    rateCounter = 0;
+    refreshCounter = 0;
+}
+
+// helper function that counts down to the next auto-repeat step and refreshes the display
+static void rateCounterRunningTick() {
+    rateCounter++;
+    if (++refreshCounter >= DISPLAY_REFRESH_MAX_VALUE) { // one redraw covers every step taken since the last one
+        clockDisplay_updateTimeDisplay(false);
+        refreshCounter = 0;
+    }
+}
+
+// transitions of each state, indexed by its select function
+static const fsm_transition_t initTransitions[] = {
+    {NULL, waiting_for_touch_st}
+};
+static const fsm_transition_t waitingForTouchTransitions[] = {
+    {NULL, adc_counter_running_st}
+};
+static const fsm_transition_t adcCounterRunningTransitions[] = {
+    [ADC_HELD] = {NULL, auto_counter_running_st},
+    [ADC_TAP] = {stepAndShow, waiting_for_touch_st}, // one step
+    [ADC_ABANDONED] = {NULL, waiting_for_touch_st}
+};
+static const fsm_transition_t autoCounterRunningTransitions[] = {
+    [AUTO_RELEASED] = {stepAndShow, waiting_for_touch_st}, // released before auto-repeat started, one step
+    [AUTO_EXPIRED] = {startRepeating, rate_counter_running_st} // held long enough, start repeating
+};
+static const fsm_transition_t rateCounterRunningTransitions[] = {
+    [RATE_RELEASED] = {showTime, waiting_for_touch_st}, // released, show the final time
+    [RATE_EXPIRED] = {repeatStep, rate_counter_running_st} // still held, step and count again
+};
+
+// select, entry, tick and exit actions and transitions of every state, in enum order
+static const fsm_state_t states[] = {
+    {NULL, NULL, NULL, NULL, FSM_TRANSITIONS(initTransitions)},
+    {waitingForTouchSelect, touchInput_clear, waitingForTouchTick, NULL, FSM_TRANSITIONS(waitingForTouchTransitions)}, // done with the last touch's point
+    {adcCounterRunningSelect, NULL, NULL, NULL, FSM_TRANSITIONS(adcCounterRunningTransitions)},
+    {autoCounterRunningSelect, NULL, autoCounterRunningTick, NULL, FSM_TRANSITIONS(autoCounterRunningTransitions)},
+    {rateCounterRunningSelect, NULL, rateCounterRunningTick, NULL, FSM_TRANSITIONS(rateCounterRunningTransitions)}
+};
+
+static const fsm_machine_t machine = {"clockControl", states, stateNames, sizeof(states) / sizeof(states[0]), init_st};
 
 // Standard tick function.
 void clockControl_tick() {
-
-    uint8_t adcCounter;
-
-    // Perform state update first.
-    // mealy actions go here as well
-  switch(currentState) {
-    case init_st:
-        currentState = waiting_for_touch_st;
-        break;
-    case waiting_for_touch_st:
-        if (display_isTouched()) {
-            currentState = adc_counter_running_st;
-            display_clearOldTouchData();
-        }
-      break;
-    case adc_counter_running_st:
-        if (display_isTouched() && (adcCounter == ADC_COUNTER_MAX_VALUE)) {
-            currentState = auto_counter_running_st;
-        }
-        else if (!display_isTouched() && (adcCounter == ADC_COUNTER_MAX_VALUE)) {
-            currentState = waiting_for_touch_st;
-        }
-      break;
-    case auto_counter_running_st:
-      break;
-    case rate_counter_running_st:
-      break;
-    case rate_counter_expired_st:
-      break;
-    case add_second_to_clock_st:
-      break;
-    default:
-      // print an error message here.
-      break;
-  }
-  
-  // Perform state action next.
-  switch(currentState) {
-    case init_st:
-        break;
-    case waiting_for_touch_st:
-        adcCounter = 0;
-        break;
-    case adc_counter_running_st:
-        adcCounter++;
-        break;
-    case auto_counter_running_st:
-        break;
-    case rate_counter_running_st:
-        break;
-    case rate_counter_expired_st:
-        break;
-    default:
-        // print an error message here.
-        break;
-  }  
+    tickMonitor_beginTick(monitorId);
+    profiler_enter("clockControl_tick");
+    touchInput_update(); // every transition this tick sees the same touch
+    uint8_t fromState = fsm_tick(&fsm);
+    profiler_exit();
+    tickMonitor_endTick(monitorId, fromState, fsm.currentState);
 }
 
 // Call this before you call clockControl_tick().
 void clockControl_init() {
-    currentState = init_st;
-}
\ No newline at end of file
+    fsm_init(&fsm, &machine);
+    if (TRACE_TRANSITIONS)
+        fsm_setHook(&fsm, fsm_printTransition);
+    profiler_init();
+    touchInput_init();
+    clockSync_init(CLOCK_TIMER);
+    if (monitorId == TICKMONITOR_NO_MACHINE)
+        monitorId = tickMonitor_addMachine("clockControl", TICK_PERIOD_INTERRUPTS, stateNames, sizeof(stateNames) / sizeof(stateNames[0])); // the clock keeps time from the timer, not from counting ticks
+}
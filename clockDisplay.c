@@ -1,9 +1,13 @@
 #include <stdint.h>
 #include <stdio.h>
-#include <utils.h>
 
 #include "clockDisplay.h"
+#include "clockTime.h"
 #include "display.h"
+#include "displayQueue.h"
+#include "profiler.h"
+#include "timerDelay.h"
+#include "touchInput.h"
 
 #define HOURS_MAXIMUM 12
 #define SEC_MIN_MAXIMUM 59
@@ -21,20 +25,187 @@
 #define TIME_RUN_TEST_LIMIT 100
 #define LONG_TIME_DELAY 1000
 #define SHORT_TIME_DELAY 100
+#define GLYPH_COLUMNS 6 // 5 font columns plus the spacing column
+#define GLYPH_ROWS 8
+#define GLYPH_FONT_COLUMNS 5
+#define NUM_OF_GLYPHS 12
+#define SPACE_GLYPH 10
+#define COLON_GLYPH 11
+#define ALL_GLYPH_COLUMNS 0x3F
+#define FIRST_COLON_CHAR 2
+#define SECOND_COLON_CHAR 5
+#define NUM_OF_SEGMENTS 7
+#define SEGMENT_THICKNESS CLOCKDISPLAY_TEXT_SIZE
+#define SEGMENT_DIGIT_WIDTH (GLYPH_FONT_COLUMNS * CLOCKDISPLAY_TEXT_SIZE) // the same box the font digits use
+#define SEGMENT_DIGIT_HEIGHT ((GLYPH_ROWS - 1) * CLOCKDISPLAY_TEXT_SIZE)
+#define SEGMENT_SIDE_LENGTH ((SEGMENT_DIGIT_HEIGHT - 3 * SEGMENT_THICKNESS) / 2)
+#define SEGMENT_BAR_LENGTH (SEGMENT_DIGIT_WIDTH - 2 * SEGMENT_THICKNESS)
+#define SEGMENT_LOWER_Y (2 * SEGMENT_THICKNESS + SEGMENT_SIDE_LENGTH)
+#define SEGMENT_RIGHT_X (SEGMENT_DIGIT_WIDTH - SEGMENT_THICKNESS)
+#define ALL_SEGMENTS 0x7F
+#define BENCHMARK_SECONDS 43200 // 12 hours
+#define HIT_TEST_BIN_WIDTH 8
+#define HIT_TEST_BINS (DISPLAY_WIDTH / HIT_TEST_BIN_WIDTH)
+#define ONE_THIRD_DISPLAY_WIDTH 107
+#define TOUCH_ROWS 2 // upper half increments, lower half decrements
+#define TOUCH_COLUMNS 3 // hours, minutes, seconds
+// set to true to draw the digits as seven-segment bars instead of font glyphs
+#define USE_SEVEN_SEGMENT_DIGITS false
+// set to true to make clockDisplay_runTest count pixels over 12 simulated hours for both renderers
+#define RUN_PIXEL_BENCHMARK false
 
-// global variables?
-uint8_t currentDisplayTime[9];
-uint8_t newTime[9];
-uint8_t hours;
-uint8_t minutes;
-uint8_t seconds;
-
-// Helper function that calculates the cursor position base don text size
-// and calls display_setCursor to reset it to the start position
-void resetCursor() {
-    uint8_t cursorStartX = HALF_DISPLAY_WIDTH - (HALF_NUM_OF_CHARS * CLOCKDISPLAY_TEXT_SIZE * DISPLAY_CHAR_WIDTH);
-    uint8_t cursorStartY = HALF_DISPLAY_HEIGHT - (DISPLAY_CHAR_HEIGHT * CLOCKDISPLAY_TEXT_SIZE / CURSOR_START_OFFSET);
-    display_setCursor(cursorStartX, cursorStartY); // set the cursor to start where the leftmost number will go
+// Column bytes of the 5x7 display font for the only characters the clock ever
+// shows: '0'-'9', ' ' and ':'. Bit 0 of each byte is the top row.
+static const uint8_t glyphFont[NUM_OF_GLYPHS][GLYPH_FONT_COLUMNS] = {
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
+    {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
+    {0x72, 0x49, 0x49, 0x49, 0x46}, // 2
+    {0x21, 0x41, 0x49, 0x4D, 0x33}, // 3
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
+    {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
+    {0x3C, 0x4A, 0x49, 0x49, 0x31}, // 6
+    {0x41, 0x21, 0x11, 0x09, 0x07}, // 7
+    {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
+    {0x46, 0x49, 0x49, 0x29, 0x1E}, // 9
+    {0x00, 0x00, 0x00, 0x00, 0x00}, // space
+    {0x00, 0x00, 0x14, 0x00, 0x00}  // colon
+};
+
+// Glyph cache, built once by clockDisplay_init. glyphRows holds each glyph as
+// one bit mask per row (bit c = column c lit). The offset tables give the pixel
+// position of every column, row and character cell at CLOCKDISPLAY_TEXT_SIZE,
+// so drawing a character needs no font lookups and no cursor moves.
+static uint8_t glyphRows[NUM_OF_GLYPHS][GLYPH_ROWS];
+static int16_t glyphColumnX[GLYPH_COLUMNS + 1];
+static int16_t glyphRowY[GLYPH_ROWS];
+static int16_t cellX[NUM_OF_CHARS];
+static int16_t cellY;
+
+// Seven-segment renderer. Segment bits are a (top) = bit 0 through g (middle)
+// = bit 6, clockwise from the top like a standard display.
+static const uint8_t segmentMasks[NUM_OF_GLYPHS] = {
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F, // 0-9
+    0x00, 0x00 // space, the colon is never drawn with segments
+};
+
+// x, y, width and height of each segment inside a digit cell
+static const int16_t segmentRects[NUM_OF_SEGMENTS][4] = {
+    {SEGMENT_THICKNESS, 0, SEGMENT_BAR_LENGTH, SEGMENT_THICKNESS}, // a, top
+    {SEGMENT_RIGHT_X, SEGMENT_THICKNESS, SEGMENT_THICKNESS, SEGMENT_SIDE_LENGTH}, // b, upper right
+    {SEGMENT_RIGHT_X, SEGMENT_LOWER_Y, SEGMENT_THICKNESS, SEGMENT_SIDE_LENGTH}, // c, lower right
+    {SEGMENT_THICKNESS, SEGMENT_DIGIT_HEIGHT - SEGMENT_THICKNESS, SEGMENT_BAR_LENGTH, SEGMENT_THICKNESS}, // d, bottom
+    {0, SEGMENT_LOWER_Y, SEGMENT_THICKNESS, SEGMENT_SIDE_LENGTH}, // e, lower left
+    {0, SEGMENT_THICKNESS, SEGMENT_THICKNESS, SEGMENT_SIDE_LENGTH}, // f, upper left
+    {SEGMENT_THICKNESS, SEGMENT_THICKNESS + SEGMENT_SIDE_LENGTH, SEGMENT_BAR_LENGTH, SEGMENT_THICKNESS} // g, middle
+};
+
+static bool useSevenSegment = USE_SEVEN_SEGMENT_DIGITS;
+static uint32_t pixelsWritten; // every pixel the digit renderers send, read by the benchmark
+
+// Touch hit-test tables. touchColumnOfBin maps every 8 pixel wide strip of the
+// screen to the field drawn above it and is filled in by clockDisplay_init, so
+// a touch is resolved with one shift and two table reads.
+static uint8_t touchColumnOfBin[HIT_TEST_BINS];
+static const uint8_t touchField[TOUCH_COLUMNS] = {CLOCKTIME_HOURS, CLOCKTIME_MINUTES, CLOCKTIME_SECONDS};
+static const int8_t touchSteps[TOUCH_ROWS] = {1, -1};
+
+// character cell that shows each time digit, the colons sit in cells 2 and 5
+static const uint8_t digitCell[CLOCKTIME_NUM_OF_DIGITS] = {0, 1, 3, 4, 6, 7};
+static uint8_t shownGlyph[CLOCKTIME_NUM_OF_DIGITS]; // the glyph each digit cell shows on the panel right now
+
+// helper function that picks the glyph for one time digit. The hours tens
+// digit is blank instead of a leading zero.
+static uint8_t digitGlyph(uint8_t digit) {
+    uint8_t value = clockTime_getDigit(digit);
+    if ((digit == CLOCKTIME_HOURS_TENS) && (value == 0))
+        return SPACE_GLYPH;
+    return value;
+}
+
+// helper function that fills the glyph cache and the offset tables
+static void buildGlyphCache() {
+    for (uint8_t g = 0; g < NUM_OF_GLYPHS; g++) { // turn the column bytes into row masks
+        for (uint8_t r = 0; r < GLYPH_ROWS; r++) {
+            glyphRows[g][r] = 0;
+            for (uint8_t c = 0; c < GLYPH_FONT_COLUMNS; c++) {
+                if (glyphFont[g][c] & (1 << r))
+                    glyphRows[g][r] |= 1 << c;
+            }
+        }
+    }
+    for (uint8_t c = 0; c <= GLYPH_COLUMNS; c++)
+        glyphColumnX[c] = c * CLOCKDISPLAY_TEXT_SIZE;
+    for (uint8_t r = 0; r < GLYPH_ROWS; r++)
+        glyphRowY[r] = r * CLOCKDISPLAY_TEXT_SIZE;
+    for (uint8_t i = 0; i < NUM_OF_CHARS; i++)
+        cellX[i] = HALF_DISPLAY_WIDTH - (HALF_NUM_OF_CHARS * CLOCKDISPLAY_TEXT_SIZE * DISPLAY_CHAR_WIDTH) + (i * CLOCKDISPLAY_TEXT_SIZE * DISPLAY_CHAR_WIDTH);
+    cellY = HALF_DISPLAY_HEIGHT - (DISPLAY_CHAR_HEIGHT * CLOCKDISPLAY_TEXT_SIZE / CURSOR_START_OFFSET);
+    for (uint8_t b = 0; b < HIT_TEST_BINS; b++) { // resolve the touch column of every strip once
+        uint8_t column = (b * HIT_TEST_BIN_WIDTH + HIT_TEST_BIN_WIDTH / 2) / ONE_THIRD_DISPLAY_WIDTH; // judge each strip by its center
+        touchColumnOfBin[b] = (column < TOUCH_COLUMNS) ? column : TOUCH_COLUMNS - 1;
+    }
+}
+
+// helper function that changes character cell "cell" from oldGlyph to newGlyph.
+// Only the font pixels that differ between the two glyphs are written, each
+// horizontal run of them as one rectangle. With forceAll every pixel of the
+// cell is written, for when the panel may not match oldGlyph.
+static void blitGlyph(uint8_t cell, uint8_t oldGlyph, uint8_t newGlyph, bool forceAll) {
+    uint8_t *oldRows = glyphRows[forceAll ? SPACE_GLYPH : oldGlyph];
+    uint8_t *newRows = glyphRows[newGlyph];
+    for (uint8_t r = 0; r < GLYPH_ROWS; r++) { // move through each font row
+        uint8_t changed = forceAll ? ALL_GLYPH_COLUMNS : (oldRows[r] ^ newRows[r]);
+        uint8_t c = 0;
+        while (c < GLYPH_COLUMNS) {
+            if (!(changed & (1 << c))) { // this pixel already shows the right color
+                c++;
+                continue;
+            }
+            bool lit = newRows[r] & (1 << c);
+            uint8_t runStart = c;
+            while ((c < GLYPH_COLUMNS) && (changed & (1 << c)) && (((newRows[r] & (1 << c)) != 0) == lit)) // extend the run while it changes to the same color
+                c++;
+            displayQueue_fillRect(cellX[cell] + glyphColumnX[runStart], cellY + glyphRowY[r], glyphColumnX[c] - glyphColumnX[runStart], CLOCKDISPLAY_TEXT_SIZE, lit ? DISPLAY_YELLOW : DISPLAY_BLACK);
+            pixelsWritten += (glyphColumnX[c] - glyphColumnX[runStart]) * CLOCKDISPLAY_TEXT_SIZE;
+        }
+    }
+}
+
+// helper function that changes a digit cell from oldGlyph to newGlyph using
+// seven-segment bars. Only the segments that turn on or off are painted, so
+// going from 8 to 9 repaints one bar. With forceAll the cell is cleared first
+// and every lit segment is drawn.
+static void drawSegments(uint8_t cell, uint8_t oldGlyph, uint8_t newGlyph, bool forceAll) {
+    uint8_t changed = segmentMasks[oldGlyph] ^ segmentMasks[newGlyph];
+    if (forceAll) { // the panel may show anything here, start from a blank cell
+        displayQueue_fillRect(cellX[cell], cellY, GLYPH_COLUMNS * CLOCKDISPLAY_TEXT_SIZE, GLYPH_ROWS * CLOCKDISPLAY_TEXT_SIZE, DISPLAY_BLACK);
+        pixelsWritten += GLYPH_COLUMNS * CLOCKDISPLAY_TEXT_SIZE * GLYPH_ROWS * CLOCKDISPLAY_TEXT_SIZE;
+        changed = segmentMasks[newGlyph];
+    }
+    for (uint8_t s = 0; s < NUM_OF_SEGMENTS; s++) {
+        if (!(changed & (1 << s)))
+            continue;
+        displayQueue_fillRect(cellX[cell] + segmentRects[s][0], cellY + segmentRects[s][1], segmentRects[s][2], segmentRects[s][3], (segmentMasks[newGlyph] & (1 << s)) ? DISPLAY_YELLOW : DISPLAY_BLACK);
+        pixelsWritten += segmentRects[s][2] * segmentRects[s][3];
+    }
+}
+
+// helper function that redraws the digits whose bit is set in changedDigits
+static void renderDigits(uint8_t changedDigits, bool forceAll) {
+    profiler_enter("renderDigits");
+    for (uint8_t d = 0; d < CLOCKTIME_NUM_OF_DIGITS; d++) {
+        if (!(changedDigits & (1 << d)))
+            continue;
+        uint8_t glyph = digitGlyph(d);
+        if (forceAll || (glyph != shownGlyph[d])) { // a digit can change without its glyph changing (hours tens 0 and blank never do)
+            if (useSevenSegment)
+                drawSegments(digitCell[d], shownGlyph[d], glyph, forceAll);
+            else
+                blitGlyph(digitCell[d], shownGlyph[d], glyph, forceAll);
+            shownGlyph[d] = glyph;
+        }
+    }
+    profiler_exit();
 }
 
 // Called only once - performs any necessary inits.
@@ -42,9 +213,7 @@ void resetCursor() {
 // parts of the clock display that will never change.
 void clockDisplay_init() {
 
-    resetCursor(); // set the cursor to where the leftmost character will go
-    display_setTextColor(DISPLAY_YELLOW); // set the text color to yellow
-    display_setTextSize(CLOCKDISPLAY_TEXT_SIZE); // set the text size
+    buildGlyphCache(); // rasterize the clock characters once
 
     uint16_t triangleHeight = (QUARTER_NUM_OF_CHARS * CLOCKDISPLAY_TEXT_SIZE * DISPLAY_CHAR_WIDTH * TRIANGLE_OFFSET_1 / TRIANGLE_OFFSET_2);
     uint16_t leftTriangleX0 = HALF_DISPLAY_WIDTH - (HALF_NUM_OF_CHARS * CLOCKDISPLAY_TEXT_SIZE * DISPLAY_CHAR_WIDTH);
@@ -60,6 +229,7 @@ void clockDisplay_init() {
     uint16_t lowerTriangleY0 = HALF_DISPLAY_HEIGHT - (CLOCKDISPLAY_TEXT_SIZE * DISPLAY_CHAR_HEIGHT * TRIANGLE_OFFSET_1 / TRIANGLE_OFFSET_2);
     uint16_t lowerTriangleY2 = lowerTriangleY0 - triangleHeight;
 
+    displayQueue_drainAll(); // the triangles go straight to the panel, so send anything queued before them first
     display_fillTriangle(leftTriangleX0, upperTriangleY0, leftTriangleX1, upperTriangleY0, leftTrangleX2, upperTriangleY2, DISPLAY_RED); // draw the upper left triangle
     display_fillTriangle(middleTriangleX0, upperTriangleY0, middleTriangleX1, upperTriangleY0, HALF_DISPLAY_WIDTH, upperTriangleY2, DISPLAY_RED); // draw the upper middle triangle
     display_fillTriangle(rightTriangleX0, upperTriangleY0, rightTriangleX1, upperTriangleY0, rightTriangleX2, upperTriangleY2, DISPLAY_RED); // draw the upper right triangle
@@ -67,123 +237,104 @@ void clockDisplay_init() {
     display_fillTriangle(middleTriangleX0, lowerTriangleY0, middleTriangleX1, lowerTriangleY0, HALF_DISPLAY_WIDTH, lowerTriangleY2, DISPLAY_RED); // draw the lower middle triangle
     display_fillTriangle(rightTriangleX0, lowerTriangleY0, rightTriangleX1, lowerTriangleY0, rightTriangleX2, lowerTriangleY2, DISPLAY_RED); // draw the lower right triangle
 
-    display_print("  :  :  "); // print the starting value for the clock
-    resetCursor(); // set the cursor to where the leftmost character will go
-    hours = HOURS_MAXIMUM;
-    minutes = seconds = SEC_MIN_MAXIMUM;
-    sprintf(currentDisplayTime, "%2hd %02hd %02hd", hours, minutes, seconds);
-    display_print(currentDisplayTime);
+    blitGlyph(FIRST_COLON_CHAR, SPACE_GLYPH, COLON_GLYPH, true); // the colons are drawn here once and never again
+    blitGlyph(SECOND_COLON_CHAR, SPACE_GLYPH, COLON_GLYPH, true);
+    clockTime_set(HOURS_MAXIMUM, SEC_MIN_MAXIMUM, SEC_MIN_MAXIMUM);
+    renderDigits(CLOCKTIME_ALL_DIGITS, true); // draw the starting time
 }
 
 // Updates the time display with latest time, making sure to update only those
 // digits that have changed since the last update. if forceUpdateAll is true,
 // update all digits.
 void clockDisplay_updateTimeDisplay(bool forceUpdateAll) {
-    resetCursor(); // set the cursor to where the leftmost character will go
-    sprintf(newTime, "%2hd %02hd %02hd", hours, minutes, seconds);
-
-    if (forceUpdateAll) { // rewrite all characters if forceUpdateAll is true
-        display_setTextColor(DISPLAY_BLACK); // set the text color to black
-        display_println(currentDisplayTime); // print the old time in black to erase it
-
-        for (uint8_t i = 0; i < NUM_OF_CHARS; i++) {
-            currentDisplayTime[i] = newTime[i];
-        }
-
-        resetCursor(); // set the cursor to where the leftmost character will go
-        display_setTextColor(DISPLAY_YELLOW); // set the text color to yellow
-        display_print(currentDisplayTime); // print the new time in yellow
-    }
-    else { // rewrite only the characters that didn't change if forceUpdateAll is false
-
-        for (uint8_t i = 0; i < NUM_OF_CHARS; i++) { // move through each index of the arrays one at a time
-
-            if (currentDisplayTime[i] == newTime[i]) { // if the character doesn't need to be updated
-                display_print(" "); // print a space (nothing) to move the cursor along on
-            }
-            else { // if there is a new character to be updated
-                display_setTextColor(DISPLAY_BLACK); // set the text color to black
-                display_printChar(currentDisplayTime[i]); // print the old character in black to erase it
-                resetCursor(); // set the cursor back to where the leftmost character will go
-
-                for (uint8_t j = 0; j < i; j++)
-                    display_print(" "); // print a space for every character that doesn't change to move the cursor back to where we just erased
-                
-                display_setTextColor(DISPLAY_YELLOW); // set the text color back to yellow
-                currentDisplayTime[i] = newTime[i];
-                display_printChar(currentDisplayTime[i]); // print the new character in yellow
-            }
-        }
-    }
+    renderDigits(CLOCKTIME_ALL_DIGITS, forceUpdateAll); // without force, digits whose glyph is already showing are skipped
 }
 
 // Reads the touched coordinates and performs the increment or decrement,
-// depending upon the touched region.
+// depending upon the touched region. Only the time is changed; the caller
+// redraws with clockDisplay_updateTimeDisplay(false), so several steps taken
+// between two redraws cost one redraw.
 void clockDisplay_performIncDec() {
-    ;
+    int16_t x, y;
+    touchInput_getPoint(&x, &y); // the filtered point of the current touch
+    if ((x < 0) || (x >= DISPLAY_WIDTH)) // ignore readings off the panel
+        return;
+    clockTime_adjust(touchField[touchColumnOfBin[x / HIT_TEST_BIN_WIDTH]], touchSteps[y >= HALF_DISPLAY_HEIGHT]);
 }
 
 // Advances the time forward by 1 second and updates the display.
+// The time core reports which digits changed, so only those cells are drawn.
 void clockDisplay_advanceTimeOneSecond() {
-    if (seconds == SEC_MIN_MAXIMUM) { // check if we need to roll over seconds
-        if (minutes == SEC_MIN_MAXIMUM) { // check if we need to roll over minutes
-            if (hours == HOURS_MAXIMUM) { // check if we need to roll over hours
-                hours = HOURS_MINIMUM;
-                minutes = seconds = SEC_MIN_MINIMUM;
-            }
-            else {
-                hours++;
-                minutes = seconds = SEC_MIN_MINIMUM;
-            }
-        }
-        else {
-            minutes++;
-            seconds = SEC_MIN_MINIMUM;
-        }
-    }
-    else {
-        seconds++;
-    }
-    clockDisplay_updateTimeDisplay(false); // update only the characters that have changed on the display
+    renderDigits(clockTime_advanceOneSecond(), false);
+}
+
+// helper function that runs the clock through 12 simulated hours with one
+// renderer and returns how many pixels the digit updates sent
+static uint32_t countPixelsOverTwelveHours(bool sevenSegment) {
+    useSevenSegment = sevenSegment;
+    renderDigits(CLOCKTIME_ALL_DIGITS, true); // switch renderers on a clean slate
+    pixelsWritten = 0;
+    for (uint32_t i = 0; i < BENCHMARK_SECONDS; i++)
+        clockDisplay_advanceTimeOneSecond();
+    return pixelsWritten;
+}
+
+// helper function that sends the queued drawing to the panel, then waits ms;
+// the test has no idle loop to drain the queue for it
+static void drawAndWait(uint32_t ms) {
+    displayQueue_drainAll();
+    timerDelay_ms(ms);
 }
 
 // Run a test of clock-display functions.
 void clockDisplay_runTest() {
+    if (RUN_PIXEL_BENCHMARK) { // compare the two digit renderers instead of running the visual test
+        clockDisplay_init();
+        uint32_t glyphPixels = countPixelsOverTwelveHours(false);
+        uint32_t segmentPixels = countPixelsOverTwelveHours(true);
+        printf("12 hours of clock updates: font glyphs %lu pixels, seven segments %lu pixels\n", (unsigned long) glyphPixels, (unsigned long) segmentPixels);
+        useSevenSegment = USE_SEVEN_SEGMENT_DIGITS;
+        clockDisplay_updateTimeDisplay(true);
+        displayQueue_drainAll();
+        return;
+    }
+
     clockDisplay_init(); // inititalize the clock 
-    utils_msDelay(LONG_TIME_DELAY); // wait for one second
+    drawAndWait(LONG_TIME_DELAY); // wait for one second
 
     for (int8_t i = HOURS_MINIMUM; i <= HOURS_MAXIMUM; i++) { // increment hours from 1 up to 12
-        hours = i;
-        utils_msDelay(100); // wait for 100ms
+        clockTime_set(i, clockTime_getMinutes(), clockTime_getSeconds());
+        drawAndWait(100); // wait for 100ms
         clockDisplay_updateTimeDisplay(false); // update only the characters that have changed on the display
     }
     for (int8_t i = HOURS_MAXIMUM; i >= HOURS_MINIMUM; i--) { // increment hours from 12 down to 1
-        hours = i;
-        utils_msDelay(100); // wait for 100ms
+        clockTime_set(i, clockTime_getMinutes(), clockTime_getSeconds());
+        drawAndWait(100); // wait for 100ms
         clockDisplay_updateTimeDisplay(false); // update only the characters that have changed on the display
     }
     for (int8_t i = SEC_MIN_MINIMUM; i <= SEC_MIN_TEST_LIMIT; i++) { // increment minutes from 0 up to 30
-        minutes = i;
-        utils_msDelay(100); // wait for 100ms
+        clockTime_set(clockTime_getHours(), i, clockTime_getSeconds());
+        drawAndWait(100); // wait for 100ms
         clockDisplay_updateTimeDisplay(false); // update only the characters that have changed on the display
     }
     for (int8_t i = SEC_MIN_TEST_LIMIT; i >= SEC_MIN_MINIMUM; i--) { // increment minutes from 30 down to 0
-        minutes = i;
-        utils_msDelay(100); // wait for 100ms
+        clockTime_set(clockTime_getHours(), i, clockTime_getSeconds());
+        drawAndWait(100); // wait for 100ms
         clockDisplay_updateTimeDisplay(false); // update only the characters that have changed on the display
     }
     for (int8_t i = SEC_MIN_MINIMUM; i <= SEC_MIN_TEST_LIMIT; i++) { // increment seconds from 0 up to 30
-        seconds = i;
-        utils_msDelay(100); // wait for 100ms
+        clockTime_set(clockTime_getHours(), clockTime_getMinutes(), i);
+        drawAndWait(100); // wait for 100ms
         clockDisplay_updateTimeDisplay(false); // update only the characters that have changed on the display
     }
     for (int8_t i = SEC_MIN_TEST_LIMIT; i >= SEC_MIN_MINIMUM; i--) { // increment seconds from 30 down to 0
-        seconds = i;
-        utils_msDelay(100); // wait for 100ms
+        clockTime_set(clockTime_getHours(), clockTime_getMinutes(), i);
+        drawAndWait(100); // wait for 100ms
         clockDisplay_updateTimeDisplay(false); // update only the characters that have changed on the display
     }
     for (int8_t i = 0; i < TIME_RUN_TEST_LIMIT; i++) { // iterate 100 times with a 100ms delay each iteration to run for 10s
         clockDisplay_advanceTimeOneSecond(); // advance the clock by one second
-        utils_msDelay(100); // wait for 100ms
+        drawAndWait(100); // wait for 100ms
     }
+    timerDelay_printStats(); // how closely the delays above were kept
 }
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "clockSync.h"
+#include "clockDisplay.h"
+#include "clockTime.h"
+#include "intervalTimer.h"
+#include "timestamp.h"
+
+static uint32_t clockTimer; // the interval timer used as the time base
+static timestamp_handle_t clockTimestamp;
+static uint64_t nextSecondTicks; // counter value at which the next second is due
+
+// Resets and starts timerNumber as the clock's time base.
+void clockSync_init(uint32_t timerNumber) {
+    clockTimer = timerNumber;
+    clockTimestamp = timestamp_getHandle(timerNumber);
+    nextSecondTicks = TIMESTAMP_TICKS_PER_SECOND;
+    intervalTimer_init(clockTimer);
+    intervalTimer_reset(clockTimer);
+    intervalTimer_start(clockTimer);
+}
+
+// Applies every whole second the timer has counted since the last update.
+// Returns the number of seconds applied (0 most of the time).
+// The count is taken from the hardware counter each time, not accumulated
+// from ticks, so late or skipped ticks never add up to drift.
+uint32_t clockSync_update() {
+    uint64_t now = timestamp_read(clockTimestamp); // integer ticks, no double divide
+    if (now < nextSecondTicks) // the common case, no second due yet
+        return 0;
+    uint32_t secondsDue = (now - nextSecondTicks) / TIMESTAMP_TICKS_PER_SECOND + 1; // one divide however long the stall was
+    nextSecondTicks += (uint64_t) secondsDue * TIMESTAMP_TICKS_PER_SECOND;
+    clockSync_advanceTime(secondsDue);
+    return secondsDue;
+}
+
+// Advances the clock by seconds with one carry pass and one redraw.
+void clockSync_advanceTime(uint32_t seconds) {
+    clockTime_advance(seconds); // any number of seconds in one pass
+    clockDisplay_updateTimeDisplay(false); // draw only the final time, only the digits that differ
+}
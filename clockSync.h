@@ -0,0 +1,22 @@
+#ifndef CLOCKSYNC_H_
+#define CLOCKSYNC_H_
+
+#include <stdint.h>
+
+// Keeps the clock locked to the 64 bit AXI interval timer instead of counting
+// ticks. Every update reads the hardware counter, works out how many whole
+// seconds have passed that the clock has not shown yet, applies all of them
+// at once and redraws only the final time. A stalled tick loop therefore
+// costs one redraw when it resumes and the clock never drifts.
+
+// Resets and starts timerNumber as the clock's time base.
+void clockSync_init(uint32_t timerNumber);
+
+// Applies every whole second the timer has counted since the last update.
+// Returns the number of seconds applied (0 most of the time).
+uint32_t clockSync_update();
+
+// Advances the clock by seconds with one carry pass and one redraw.
+void clockSync_advanceTime(uint32_t seconds);
+
+#endif /* CLOCKSYNC_H_ */
@@ -0,0 +1,118 @@
+#include "clockTime.h"
+
+#define DECIMAL_BASE 10
+#define SIXTY_BASE 6 // the tens digit of minutes and seconds counts 0-5
+#define HOURS_PER_CYCLE 12
+#define HOURS_MINIMUM 1
+#define MINUTES_PER_HOUR 60
+#define SECONDS_PER_MINUTE 60
+#define SECONDS_PER_CYCLE (HOURS_PER_CYCLE * MINUTES_PER_HOUR * SECONDS_PER_MINUTE) // the clock shows the same time every 12 hours
+
+static uint8_t timeDigits[CLOCKTIME_NUM_OF_DIGITS];
+
+// counting base of each minute and second digit, hours are handled separately
+static const uint8_t digitBase[CLOCKTIME_NUM_OF_DIGITS] = {0, 0, SIXTY_BASE, DECIMAL_BASE, SIXTY_BASE, DECIMAL_BASE};
+
+// helper function that returns the hours as a binary number
+static uint8_t readHours() {
+    return timeDigits[CLOCKTIME_HOURS_TENS] * DECIMAL_BASE + timeDigits[CLOCKTIME_HOURS_ONES];
+}
+
+// helper function that stores hours (1-12) and returns the mask of the hour digits that changed
+static uint8_t writeHours(uint8_t hours) {
+    uint8_t changed = 0;
+    if (timeDigits[CLOCKTIME_HOURS_TENS] != hours / DECIMAL_BASE)
+        changed |= 1 << CLOCKTIME_HOURS_TENS;
+    if (timeDigits[CLOCKTIME_HOURS_ONES] != hours % DECIMAL_BASE)
+        changed |= 1 << CLOCKTIME_HOURS_ONES;
+    timeDigits[CLOCKTIME_HOURS_TENS] = hours / DECIMAL_BASE;
+    timeDigits[CLOCKTIME_HOURS_ONES] = hours % DECIMAL_BASE;
+    return changed;
+}
+
+// Sets the time. Hours must be 1-12, minutes and seconds 0-59.
+uint8_t clockTime_set(uint8_t hours, uint8_t minutes, uint8_t seconds) {
+    uint8_t newDigits[CLOCKTIME_NUM_OF_DIGITS] = {0, 0, minutes / DECIMAL_BASE, minutes % DECIMAL_BASE, seconds / DECIMAL_BASE, seconds % DECIMAL_BASE};
+    uint8_t changed = writeHours(hours);
+    for (uint8_t d = CLOCKTIME_MINUTES_TENS; d < CLOCKTIME_NUM_OF_DIGITS; d++) {
+        if (timeDigits[d] != newDigits[d])
+            changed |= 1 << d;
+        timeDigits[d] = newDigits[d];
+    }
+    return changed;
+}
+
+// Advances the time by one second, rolling 12:59:59 over to 1:00:00.
+// Each digit that wraps to 0 passes a carry to the one on its left; the
+// first digit that does not wrap ends the ripple.
+uint8_t clockTime_advanceOneSecond() {
+    uint8_t changed = 0;
+    for (int8_t d = CLOCKTIME_SECONDS_ONES; d >= CLOCKTIME_MINUTES_TENS; d--) { // seconds, then minutes
+        changed |= 1 << d;
+        if (++timeDigits[d] < digitBase[d]) // no carry, done
+            return changed;
+        timeDigits[d] = 0;
+    }
+    if (readHours() == HOURS_PER_CYCLE) // 12 rolls over to 1
+        return changed | writeHours(HOURS_MINIMUM);
+    return changed | writeHours(readHours() + 1);
+}
+
+// Advances the time by any number of seconds with one pass of carries.
+// The carry into each digit can be larger than 1, so the cost does not depend
+// on how many seconds are applied.
+uint8_t clockTime_advance(uint32_t seconds) {
+    uint8_t changed = 0;
+    uint32_t carry = seconds % SECONDS_PER_CYCLE; // whole 12 hour cycles change nothing, and the sums below can't overflow
+    for (int8_t d = CLOCKTIME_SECONDS_ONES; (d >= CLOCKTIME_MINUTES_TENS) && carry; d--) { // seconds, then minutes
+        uint32_t total = timeDigits[d] + carry;
+        if (timeDigits[d] != total % digitBase[d])
+            changed |= 1 << d;
+        timeDigits[d] = total % digitBase[d];
+        carry = total / digitBase[d];
+    }
+    if (carry) // whole hours left over, hours count 1-12
+        changed |= writeHours(((readHours() - HOURS_MINIMUM + carry) % HOURS_PER_CYCLE) + HOURS_MINIMUM);
+    return changed;
+}
+
+// helper function that wraps value + steps into [minimum, minimum + range)
+static uint8_t wrapField(uint8_t value, int16_t steps, uint8_t minimum, uint8_t range) {
+    int16_t wrapped = (value - minimum + steps) % range;
+    if (wrapped < 0) // % keeps the sign of the dividend
+        wrapped += range;
+    return wrapped + minimum;
+}
+
+// Moves one field up (steps > 0) or down (steps < 0) by any number of steps,
+// wrapping within the field without carrying into the others. This is how
+// the time is set by hand.
+uint8_t clockTime_adjust(uint8_t field, int16_t steps) {
+    uint8_t hours = clockTime_getHours();
+    uint8_t minutes = clockTime_getMinutes();
+    uint8_t seconds = clockTime_getSeconds();
+    if (field == CLOCKTIME_HOURS)
+        hours = wrapField(hours, steps, HOURS_MINIMUM, HOURS_PER_CYCLE);
+    else if (field == CLOCKTIME_MINUTES)
+        minutes = wrapField(minutes, steps, 0, MINUTES_PER_HOUR);
+    else
+        seconds = wrapField(seconds, steps, 0, MINUTES_PER_HOUR);
+    return clockTime_set(hours, minutes, seconds);
+}
+
+// Returns digit n of the time (0-9). Use the CLOCKTIME_* digit positions.
+uint8_t clockTime_getDigit(uint8_t digit) {
+    return timeDigits[digit];
+}
+
+uint8_t clockTime_getHours() {
+    return readHours();
+}
+
+uint8_t clockTime_getMinutes() {
+    return timeDigits[CLOCKTIME_MINUTES_TENS] * DECIMAL_BASE + timeDigits[CLOCKTIME_MINUTES_ONES];
+}
+
+uint8_t clockTime_getSeconds() {
+    return timeDigits[CLOCKTIME_SECONDS_TENS] * DECIMAL_BASE + timeDigits[CLOCKTIME_SECONDS_ONES];
+}
@@ -0,0 +1,47 @@
+#ifndef CLOCKTIME_H_
+#define CLOCKTIME_H_
+
+#include <stdint.h>
+
+// BCD time core for the 12 hour clock. The time is kept as six decimal digits
+// (hh:mm:ss) and advanced by ripple carry, so the display never has to format
+// or compare strings. Every call that changes the time returns a bit mask with
+// bit n set for each digit n that changed.
+
+#define CLOCKTIME_HOURS_TENS 0
+#define CLOCKTIME_HOURS_ONES 1
+#define CLOCKTIME_MINUTES_TENS 2
+#define CLOCKTIME_MINUTES_ONES 3
+#define CLOCKTIME_SECONDS_TENS 4
+#define CLOCKTIME_SECONDS_ONES 5
+#define CLOCKTIME_NUM_OF_DIGITS 6
+#define CLOCKTIME_ALL_DIGITS 0x3F
+
+// Fields for clockTime_adjust.
+#define CLOCKTIME_HOURS 0
+#define CLOCKTIME_MINUTES 1
+#define CLOCKTIME_SECONDS 2
+
+// Sets the time. Hours must be 1-12, minutes and seconds 0-59.
+uint8_t clockTime_set(uint8_t hours, uint8_t minutes, uint8_t seconds);
+
+// Advances the time by one second, rolling 12:59:59 over to 1:00:00.
+uint8_t clockTime_advanceOneSecond();
+
+// Advances the time by any number of seconds with one pass of carries.
+uint8_t clockTime_advance(uint32_t seconds);
+
+// Moves one field up (steps > 0) or down (steps < 0) by any number of steps,
+// wrapping within the field without carrying into the others. This is how
+// the time is set by hand.
+uint8_t clockTime_adjust(uint8_t field, int16_t steps);
+
+// Returns digit n of the time (0-9). Use the CLOCKTIME_* digit positions.
+uint8_t clockTime_getDigit(uint8_t digit);
+
+// Binary fields, for code that needs to do arithmetic on the time.
+uint8_t clockTime_getHours();
+uint8_t clockTime_getMinutes();
+uint8_t clockTime_getSeconds();
+
+#endif /* CLOCKTIME_H_ */
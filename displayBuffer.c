@@ -0,0 +1,136 @@
+#include "displayBuffer.h"
+#include "display.h"
+#include "displayQueue.h"
+
+#define BITS_PER_WORD 32
+#define DIRTY_WORDS_PER_ROW ((DISPLAY_WIDTH + BITS_PER_WORD - 1) / BITS_PER_WORD)
+#define BUFFER_ROWS (DISPLAYBUFFER_ENABLED ? DISPLAY_HEIGHT : 1) // turned off, the buffer keeps one row and clips everything below it
+
+// a rectangle in inclusive pixel coordinates
+typedef struct {
+    int16_t x0, y0, x1, y1;
+} dirtyRect_t;
+
+static uint16_t frameBuffer[BUFFER_ROWS][DISPLAY_WIDTH]; // what the panel will show after the next flush
+static uint32_t dirtyPixels[BUFFER_ROWS][DIRTY_WORDS_PER_ROW]; // one bit per pixel touched since the last flush
+static dirtyRect_t dirtyRects[DISPLAYBUFFER_MAX_DIRTY_RECTS]; // bounds of the touched pixels, so flush does not scan the whole screen
+static uint8_t dirtyRectCount;
+
+// helper function that returns true if two rectangles overlap or touch
+static bool rectsTouch(dirtyRect_t *a, dirtyRect_t *b) {
+    return (a->x0 <= b->x1 + 1) && (b->x0 <= a->x1 + 1) && (a->y0 <= b->y1 + 1) && (b->y0 <= a->y1 + 1);
+}
+
+// helper function that grows a to cover b as well
+static void mergeRect(dirtyRect_t *a, dirtyRect_t *b) {
+    a->x0 = (b->x0 < a->x0) ? b->x0 : a->x0;
+    a->y0 = (b->y0 < a->y0) ? b->y0 : a->y0;
+    a->x1 = (b->x1 > a->x1) ? b->x1 : a->x1;
+    a->y1 = (b->y1 > a->y1) ? b->y1 : a->y1;
+}
+
+// helper function that records the bounding box of one primitive. It is merged
+// into a rectangle it touches, or into the first one if the list is full.
+static void markDirtyRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    dirtyRect_t rect = {x0 < 0 ? 0 : x0, y0 < 0 ? 0 : y0, x1 >= DISPLAY_WIDTH ? DISPLAY_WIDTH - 1 : x1, y1 >= BUFFER_ROWS ? BUFFER_ROWS - 1 : y1};
+    if ((rect.x0 > rect.x1) || (rect.y0 > rect.y1)) // completely off screen
+        return;
+    for (uint8_t i = 0; i < dirtyRectCount; i++) {
+        if (rectsTouch(&dirtyRects[i], &rect)) {
+            mergeRect(&dirtyRects[i], &rect);
+            return;
+        }
+    }
+    if (dirtyRectCount < DISPLAYBUFFER_MAX_DIRTY_RECTS)
+        dirtyRects[dirtyRectCount++] = rect;
+    else
+        mergeRect(&dirtyRects[0], &rect);
+}
+
+// Fills the buffer with color without sending anything and clears all dirty state.
+// Use the color the panel already shows (normally DISPLAY_BLACK).
+void displayBuffer_init(uint16_t color) {
+    for (int16_t y = 0; y < BUFFER_ROWS; y++) {
+        for (int16_t x = 0; x < DISPLAY_WIDTH; x++)
+            frameBuffer[y][x] = color;
+        for (int16_t w = 0; w < DIRTY_WORDS_PER_ROW; w++)
+            dirtyPixels[y][w] = 0;
+    }
+    dirtyRectCount = 0;
+}
+
+// helper function that writes one pixel into RAM and marks it, without touching the rectangle list
+static void plot(int16_t x, int16_t y, uint16_t color) {
+    if ((x < 0) || (y < 0) || (x >= DISPLAY_WIDTH) || (y >= BUFFER_ROWS)) // clip to the panel
+        return;
+    frameBuffer[y][x] = color;
+    dirtyPixels[y][x / BITS_PER_WORD] |= 1UL << (x % BITS_PER_WORD);
+}
+
+void displayBuffer_drawPixel(int16_t x, int16_t y, uint16_t color) {
+    plot(x, y, color);
+    markDirtyRect(x, y, x, y);
+}
+
+void displayBuffer_drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++)
+        plot(x + i, y, color);
+    markDirtyRect(x, y, x + w - 1, y);
+}
+
+void displayBuffer_drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++)
+        plot(x, y + i, color);
+    markDirtyRect(x, y, x, y + h - 1);
+}
+
+void displayBuffer_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t j = 0; j < h; j++) {
+        for (int16_t i = 0; i < w; i++)
+            plot(x + i, y + j, color);
+    }
+    markDirtyRect(x, y, x + w - 1, y + h - 1);
+}
+
+// helper function that returns true if pixel (x, y) was touched since the last flush
+static bool isDirty(int16_t x, int16_t y) {
+    return dirtyPixels[y][x / BITS_PER_WORD] & (1UL << (x % BITS_PER_WORD));
+}
+
+// helper function that clears the dirty bits of pixels x0 to x1 (inclusive) in row y, a word at a time
+static void clearDirty(int16_t y, int16_t x0, int16_t x1) {
+    for (int16_t w = x0 / BITS_PER_WORD; w <= x1 / BITS_PER_WORD; w++) {
+        int16_t first = (x0 > w * BITS_PER_WORD) ? x0 % BITS_PER_WORD : 0; // first and last bit of the run inside this word
+        int16_t last = (x1 < (w + 1) * BITS_PER_WORD - 1) ? x1 % BITS_PER_WORD : BITS_PER_WORD - 1;
+        uint32_t mask = (0xFFFFFFFFUL >> (BITS_PER_WORD - 1 - last)) & (0xFFFFFFFFUL << first);
+        dirtyPixels[y][w] &= ~mask; // other rectangles' pixels in the same word stay dirty
+    }
+}
+
+// Sends every touched pixel to the panel and clears the dirty state.
+// Returns the estimated number of bytes this put on the LCD bus.
+uint32_t displayBuffer_flush() {
+    uint32_t busBytes = 0;
+    displayQueue_drainAll(); // anything queued before these pixels were drawn goes to the panel first
+    for (uint8_t i = 0; i < dirtyRectCount; i++) {
+        dirtyRect_t *rect = &dirtyRects[i];
+        for (int16_t y = rect->y0; y <= rect->y1; y++) {
+            int16_t x = rect->x0;
+            while (x <= rect->x1) {
+                if (!isDirty(x, y)) { // untouched pixels are already right on the panel
+                    x++;
+                    continue;
+                }
+                int16_t runStart = x;
+                uint16_t color = frameBuffer[y][x];
+                while ((x <= rect->x1) && isDirty(x, y) && (frameBuffer[y][x] == color)) // grow the run while it is touched and one color
+                    x++;
+                display_drawFastHLine(runStart, y, x - runStart, color); // one address window, then a burst of pixels
+                busBytes += DISPLAYBUFFER_WINDOW_BYTES + (x - runStart) * DISPLAYBUFFER_PIXEL_BYTES;
+                clearDirty(y, runStart, x - 1); // sent, so an overlapping rectangle does not send it again
+            }
+        }
+    }
+    dirtyRectCount = 0;
+    return busBytes;
+}
@@ -0,0 +1,39 @@
+#ifndef DISPLAYBUFFER_H_
+#define DISPLAYBUFFER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Optional RGB565 back buffer for the LCD. Draws land in RAM and mark the
+// pixels they touch; displayBuffer_flush() then sends only the touched pixels,
+// as horizontal runs of one color, inside a handful of merged dirty rectangles.
+// A pixel that is drawn several times before a flush (erase then redraw) goes
+// over the bus once. Pixels that were never touched are never sent, so code
+// that still draws straight through display.h can share the panel safely.
+
+// set to 1 to route tic-tac-toe symbol drawing through the back buffer. The
+// buffer and its dirty bitmap take about 160 KB of RAM (320 x 240 pixels at
+// 2 bytes plus 1 bit each); at 0 they shrink to a single row.
+#define DISPLAYBUFFER_ENABLED 0
+
+#define DISPLAYBUFFER_MAX_DIRTY_RECTS 8
+
+// Fills the buffer with color without sending anything and clears all dirty state.
+// Use the color the panel already shows (normally DISPLAY_BLACK).
+void displayBuffer_init(uint16_t color);
+
+// Drawing calls with the same arguments as their display.h counterparts.
+void displayBuffer_drawPixel(int16_t x, int16_t y, uint16_t color);
+void displayBuffer_drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+void displayBuffer_drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+void displayBuffer_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+// Sends every touched pixel to the panel and clears the dirty state.
+// Returns the estimated number of bytes this put on the LCD bus.
+uint32_t displayBuffer_flush();
+
+// Estimated LCD bus bytes for one address window and for one pixel of data.
+#define DISPLAYBUFFER_WINDOW_BYTES 11
+#define DISPLAYBUFFER_PIXEL_BYTES 2
+
+#endif /* DISPLAYBUFFER_H_ */
@@ -0,0 +1,157 @@
+#include "displayQueue.h"
+#include "display.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define QUEUE_MASK (DISPLAYQUEUE_SIZE - 1)
+#define CIRCLE_PIXELS_NUMERATOR 45 // a circle outline is about 2 * pi * r = 6.3 r pixels
+#define CIRCLE_PIXELS_DENOMINATOR 7
+
+// kinds of queued command
+typedef enum {
+    LINE_CMD,
+    HLINE_CMD,
+    FILL_RECT_CMD,
+    CIRCLE_CMD,
+    TEXT_CMD,
+    NUM_OF_CMDS
+} command_type_t;
+
+// one queued draw; a, b, c, d hold the coordinates in display.h argument order
+typedef struct {
+    uint8_t type;
+    uint8_t textSize;
+    uint16_t color;
+    int16_t a, b, c, d;
+    uint32_t cost; // estimated pixels, charged against the drain budget
+    const char *text;
+} command_t;
+
+static command_t ring[DISPLAYQUEUE_SIZE];
+static uint16_t head; // next free slot, moved by push
+static uint16_t tail; // next command to run, moved by drainCommands
+
+// per command type accounting
+static uint32_t commandCount[NUM_OF_CMDS];
+static uint32_t commandCost[NUM_OF_CMDS];
+static uint32_t maxCommandCost;
+static uint32_t backPressureStalls;
+static uint16_t maxPending;
+
+static const char *commandNames[NUM_OF_CMDS] = {"line", "hline", "fillRect", "circle", "text"};
+
+// helper function that runs one command on the panel
+static void execute(const command_t *command) {
+    switch (command->type) {
+        case LINE_CMD:
+            display_drawLine(command->a, command->b, command->c, command->d, command->color);
+            break;
+        case HLINE_CMD:
+            display_drawFastHLine(command->a, command->b, command->c, command->color);
+            break;
+        case FILL_RECT_CMD:
+            display_fillRect(command->a, command->b, command->c, command->d, command->color);
+            break;
+        case CIRCLE_CMD:
+            display_drawCircle(command->a, command->b, command->c, command->color);
+            break;
+        case TEXT_CMD:
+            display_setTextColor(command->color);
+            display_setTextSize(command->textSize);
+            display_setCursor(command->a, command->b);
+            display_print(command->text);
+            break;
+        default:
+            break;
+    }
+    commandCount[command->type]++;
+    commandCost[command->type] += command->cost;
+    if (command->cost > maxCommandCost)
+        maxCommandCost = command->cost;
+}
+
+// helper function that runs the oldest commands until budget is used up
+static uint32_t drainCommands(uint32_t budget) {
+    uint32_t spent = 0;
+    while ((tail != head) && ((spent == 0) || (spent < budget))) { // always make progress, then stop at the budget
+        const command_t *command = &ring[tail & QUEUE_MASK];
+        execute(command);
+        spent += command->cost;
+        tail++;
+    }
+    return spent;
+}
+
+// helper function that queues one command, or runs it right away when the queue is turned off
+static void push(command_t *command) {
+    if (!DISPLAYQUEUE_ENABLED) {
+        execute(command);
+        return;
+    }
+    if ((uint16_t) (head - tail) == DISPLAYQUEUE_SIZE) { // full: make room ourselves instead of dropping or reordering
+        drainCommands(command->cost);
+        backPressureStalls++;
+    }
+    ring[head & QUEUE_MASK] = *command;
+    head++;
+    if ((uint16_t) (head - tail) > maxPending)
+        maxPending = head - tail;
+}
+
+void displayQueue_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    uint32_t length = (abs(x1 - x0) > abs(y1 - y0)) ? abs(x1 - x0) : abs(y1 - y0);
+    command_t command = {LINE_CMD, 0, color, x0, y0, x1, y1, length + 1, NULL};
+    push(&command);
+}
+
+void displayQueue_drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    command_t command = {HLINE_CMD, 0, color, x, y, w, 0, w, NULL};
+    push(&command);
+}
+
+void displayQueue_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    command_t command = {FILL_RECT_CMD, 0, color, x, y, w, h, (uint32_t) w * h, NULL};
+    push(&command);
+}
+
+void displayQueue_drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    command_t command = {CIRCLE_CMD, 0, color, x0, y0, r, 0, (uint32_t) r * CIRCLE_PIXELS_NUMERATOR / CIRCLE_PIXELS_DENOMINATOR, NULL};
+    push(&command);
+}
+
+void displayQueue_print(int16_t x, int16_t y, const char *text, uint8_t size, uint16_t color) {
+    uint32_t cost = strlen(text) * (DISPLAY_CHAR_WIDTH * size) * (DISPLAY_CHAR_HEIGHT * size); // whole character cells, an upper bound
+    command_t command = {TEXT_CMD, size, color, x, y, 0, 0, cost, text};
+    push(&command);
+}
+
+// Executes queued commands until their estimated cost reaches budget pixels
+// (at least one command runs if any are waiting). Returns the cost executed.
+// Call from the main loop only, never from an interrupt.
+uint32_t displayQueue_drain(uint32_t budget) {
+    return drainCommands(budget);
+}
+
+// Executes everything that is queued. Returns the cost executed.
+uint32_t displayQueue_drainAll() {
+    uint32_t spent = 0;
+    while (displayQueue_pending())
+        spent += displayQueue_drain(UINT32_MAX);
+    return spent;
+}
+
+// Number of commands waiting.
+uint16_t displayQueue_pending() {
+    return head - tail;
+}
+
+// Prints command counts, pixel costs and back-pressure stalls.
+void displayQueue_printStats() {
+    if (!DISPLAYQUEUE_ENABLED) // every draw ran right away, nothing to report
+        return;
+    for (uint8_t i = 0; i < NUM_OF_CMDS; i++)
+        printf("%-9s %8lu commands %10lu pixels\n", commandNames[i], (unsigned long) commandCount[i], (unsigned long) commandCost[i]);
+    printf("largest command %lu pixels, deepest queue %u, back-pressure stalls %lu\n", (unsigned long) maxCommandCost, maxPending, (unsigned long) backPressureStalls);
+}
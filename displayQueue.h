@@ -0,0 +1,50 @@
+#ifndef DISPLAYQUEUE_H_
+#define DISPLAYQUEUE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Asynchronous display command queue. Tick functions push compact draw
+// commands instead of waiting on the panel; the main loop drains them a
+// bounded amount at a time whenever no task is ready. Draining never
+// happens in an interrupt: the panel's cursor, text color and size and the
+// SPI bus it shares with the touch controller belong to whoever is running
+// in the main context, and an interrupt could land in the middle of their
+// transaction. Code that draws straight through display.h after queueing
+// must call displayQueue_drainAll first so the panel sees the draws in order.
+//
+// Back-pressure: if a push finds the ring full it executes the oldest
+// commands itself until one slot is free, so nothing is dropped and order is
+// kept, and the stall is counted.
+//
+// With DISPLAYQUEUE_ENABLED set to 0 every call below draws immediately, so
+// modules can always draw through this interface.
+
+#define DISPLAYQUEUE_ENABLED 0
+#define DISPLAYQUEUE_SIZE 1024 // must be a power of two
+#define DISPLAYQUEUE_IDLE_BUDGET 2000 // pixels drained per pass of the idle loop
+
+// Draw calls with the same arguments as their display.h counterparts. The
+// text string must stay valid until the command is drained (use literals).
+void displayQueue_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+void displayQueue_drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+void displayQueue_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+void displayQueue_drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+void displayQueue_print(int16_t x, int16_t y, const char *text, uint8_t size, uint16_t color);
+
+// Executes queued commands until their estimated cost reaches budget pixels
+// (at least one command runs if any are waiting). Returns the cost executed.
+// Call from the main loop only, never from an interrupt.
+uint32_t displayQueue_drain(uint32_t budget);
+
+// Executes everything that is queued. Returns the cost executed.
+uint32_t displayQueue_drainAll();
+
+// Number of commands waiting.
+uint16_t displayQueue_pending();
+
+// Prints command counts, pixel costs and back-pressure stalls. Prints
+// nothing with the queue turned off.
+void displayQueue_printStats();
+
+#endif /* DISPLAYQUEUE_H_ */
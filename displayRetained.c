@@ -0,0 +1,94 @@
+#include "displayRetained.h"
+#include "display.h"
+#include "displayQueue.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const displayRetained_element_t *elements[DISPLAYRETAINED_MAX_ELEMENTS]; // declared elements
+static bool showing[DISPLAYRETAINED_MAX_ELEMENTS]; // true if the element is on the panel right now
+static uint8_t elementCount;
+static uint8_t currentScreen;
+static uint16_t backgroundColor;
+static uint32_t pixelsWritten;
+
+// helper function that draws one element in the given color and adds an
+// estimate of the pixels it sends to the running count
+static void drawElement(const displayRetained_element_t *element, uint16_t color) {
+    switch (element->kind) {
+        case DISPLAYRETAINED_TEXT:
+            displayQueue_print(element->x0, element->y0, element->text, element->textSize, color);
+            pixelsWritten += strlen(element->text) * (DISPLAY_CHAR_WIDTH * element->textSize) * (DISPLAY_CHAR_HEIGHT * element->textSize); // whole character cells, an upper bound
+            break;
+        case DISPLAYRETAINED_LINE:
+            displayQueue_drawLine(element->x0, element->y0, element->x1, element->y1, color);
+            if (abs(element->x1 - element->x0) > abs(element->y1 - element->y0)) // a line writes one pixel per step along its longer axis
+                pixelsWritten += abs(element->x1 - element->x0) + 1;
+            else
+                pixelsWritten += abs(element->y1 - element->y0) + 1;
+            break;
+        case DISPLAYRETAINED_FILLED_RECT:
+            displayQueue_fillRect(element->x0, element->y0, element->x1, element->y1, color);
+            pixelsWritten += element->x1 * element->y1;
+            break;
+        default:
+            break;
+    }
+}
+
+// Forgets all elements and sets the background color used to erase them.
+// Does not touch the panel.
+void displayRetained_init(uint16_t background) {
+    elementCount = 0;
+    currentScreen = DISPLAYRETAINED_NO_SCREEN;
+    backgroundColor = background;
+    pixelsWritten = 0;
+}
+
+// Registers count elements from a static table. Elements start out hidden.
+void displayRetained_declare(const displayRetained_element_t *table, uint8_t count) {
+    for (uint8_t i = 0; (i < count) && (elementCount < DISPLAYRETAINED_MAX_ELEMENTS); i++) { // ignore anything past the end of the element list
+        elements[elementCount] = &table[i];
+        showing[elementCount] = false;
+        elementCount++;
+    }
+}
+
+// Makes screen the visible one: erases the elements of every other screen that
+// are showing, then draws the elements of this screen that are not showing yet.
+// Calling it again for the screen that is already up sends nothing.
+void displayRetained_showScreen(uint8_t screen) {
+    if (screen == currentScreen) // nothing changed, nothing to send
+        return;
+    for (uint8_t i = 0; i < elementCount; i++) { // erase first so the new screen is not drawn over by an erase
+        if (showing[i] && (elements[i]->screen != screen)) {
+            drawElement(elements[i], backgroundColor);
+            showing[i] = false;
+        }
+    }
+    for (uint8_t i = 0; i < elementCount; i++) { // then draw what is missing
+        if (!showing[i] && (elements[i]->screen == screen)) {
+            drawElement(elements[i], elements[i]->color);
+            showing[i] = true;
+        }
+    }
+    currentScreen = screen;
+}
+
+// Erases every element that is showing.
+void displayRetained_hideAll() {
+    for (uint8_t i = 0; i < elementCount; i++) {
+        if (showing[i]) {
+            drawElement(elements[i], backgroundColor);
+            showing[i] = false;
+        }
+    }
+    currentScreen = DISPLAYRETAINED_NO_SCREEN;
+}
+
+// Estimated pixels sent to the panel since the last call, then resets the count.
+uint32_t displayRetained_takePixelsWritten() {
+    uint32_t pixels = pixelsWritten;
+    pixelsWritten = 0;
+    return pixels;
+}
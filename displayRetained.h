@@ -0,0 +1,52 @@
+#ifndef DISPLAYRETAINED_H_
+#define DISPLAYRETAINED_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Retained-mode layer over display.h. Static parts of a screen (text lines,
+// board lines) are declared once as elements that belong to a screen. The
+// layer remembers what is on the panel and only sends display_* calls when an
+// element actually appears or disappears, so a state that keeps asking for
+// the same screen every tick costs no bus traffic.
+
+#define DISPLAYRETAINED_MAX_ELEMENTS 16
+#define DISPLAYRETAINED_NO_SCREEN 0xFF
+
+// Kinds of element the layer knows how to draw.
+typedef enum {
+    DISPLAYRETAINED_TEXT, // text at (x0, y0) in textSize
+    DISPLAYRETAINED_LINE, // line from (x0, y0) to (x1, y1)
+    DISPLAYRETAINED_FILLED_RECT // rectangle at (x0, y0) that is x1 wide and y1 tall
+} displayRetained_kind_t;
+
+// One element of a screen. Callers declare these as static const tables; the
+// layer keeps a pointer, not a copy.
+typedef struct {
+    displayRetained_kind_t kind;
+    uint8_t screen; // the screen this element belongs to
+    int16_t x0, y0, x1, y1;
+    const char *text; // only used by DISPLAYRETAINED_TEXT
+    uint8_t textSize; // only used by DISPLAYRETAINED_TEXT
+    uint16_t color;
+} displayRetained_element_t;
+
+// Forgets all elements and sets the background color used to erase them.
+// Does not touch the panel.
+void displayRetained_init(uint16_t background);
+
+// Registers count elements from a static table. Elements start out hidden.
+void displayRetained_declare(const displayRetained_element_t *elements, uint8_t count);
+
+// Makes screen the visible one: erases the elements of every other screen that
+// are showing, then draws the elements of this screen that are not showing yet.
+// Calling it again for the screen that is already up sends nothing.
+void displayRetained_showScreen(uint8_t screen);
+
+// Erases every element that is showing.
+void displayRetained_hideAll();
+
+// Estimated pixels sent to the panel since the last call, then resets the count.
+uint32_t displayRetained_takePixelsWritten();
+
+#endif /* DISPLAYRETAINED_H_ */
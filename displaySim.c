@@ -0,0 +1,466 @@
+#include "displaySim.h"
+#include "display.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WINDOW_BYTES 11 // column and page address commands plus the memory write command
+#define PIXEL_BYTES 2 // one RGB565 pixel
+#define FONT_FIRST_CHAR 0x20
+#define FONT_LAST_CHAR 0x7E
+#define FONT_COLUMNS 5
+#define CHAR_ROWS 8
+#define CHAR_COLUMNS 6 // 5 font columns and one blank column
+#define RGB565_RED_SHIFT 11
+#define RGB565_GREEN_SHIFT 5
+#define RGB565_5_BIT_MASK 0x1F
+#define RGB565_6_BIT_MASK 0x3F
+#define PPM_MAX_VALUE 255
+
+// the printable part of the 5x7 font the driver uses, one byte per column, bit 0 at the top
+static const uint8_t font[FONT_LAST_CHAR - FONT_FIRST_CHAR + 1][FONT_COLUMNS] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00}, {0x14, 0x7F, 0x14, 0x7F, 0x14}, //  !"#
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62}, {0x36, 0x49, 0x56, 0x20, 0x50}, {0x00, 0x08, 0x07, 0x03, 0x00}, // $%&'
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x2A, 0x1C, 0x7F, 0x1C, 0x2A}, {0x08, 0x08, 0x3E, 0x08, 0x08}, // ()*+
+    {0x00, 0x80, 0x70, 0x30, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x00, 0x60, 0x60, 0x00}, {0x20, 0x10, 0x08, 0x04, 0x02}, // ,-./
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00}, {0x72, 0x49, 0x49, 0x49, 0x46}, {0x21, 0x41, 0x49, 0x4D, 0x33}, // 0123
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x31}, {0x41, 0x21, 0x11, 0x09, 0x07}, // 4567
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x46, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x00, 0x14, 0x00, 0x00}, {0x00, 0x40, 0x34, 0x00, 0x00}, // 89:;
+    {0x00, 0x08, 0x14, 0x22, 0x41}, {0x14, 0x14, 0x14, 0x14, 0x14}, {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x59, 0x09, 0x06}, // <=>?
+    {0x3E, 0x41, 0x5D, 0x59, 0x4E}, {0x7C, 0x12, 0x11, 0x12, 0x7C}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22}, // @ABC
+    {0x7F, 0x41, 0x41, 0x41, 0x3E}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01}, {0x3E, 0x41, 0x41, 0x51, 0x73}, // DEFG
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00}, {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, // HIJK
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, {0x7F, 0x02, 0x1C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E}, // LMNO
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46}, {0x26, 0x49, 0x49, 0x49, 0x32}, // PQRS
+    {0x03, 0x01, 0x7F, 0x01, 0x03}, {0x3F, 0x40, 0x40, 0x40, 0x3F}, {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, // TUVW
+    {0x63, 0x14, 0x08, 0x14, 0x63}, {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x59, 0x49, 0x4D, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x41}, // XYZ[
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x41, 0x7F}, {0x04, 0x02, 0x01, 0x02, 0x04}, {0x40, 0x40, 0x40, 0x40, 0x40}, // \]^_
+    {0x00, 0x03, 0x07, 0x08, 0x00}, {0x20, 0x54, 0x54, 0x78, 0x40}, {0x7F, 0x28, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x28}, // `abc
+    {0x38, 0x44, 0x44, 0x28, 0x7F}, {0x38, 0x54, 0x54, 0x54, 0x18}, {0x00, 0x08, 0x7E, 0x09, 0x02}, {0x18, 0xA4, 0xA4, 0x9C, 0x78}, // defg
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x40, 0x3D, 0x00}, {0x7F, 0x10, 0x28, 0x44, 0x00}, // hijk
+    {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x78, 0x04, 0x78}, {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, // lmno
+    {0xFC, 0x18, 0x24, 0x24, 0x18}, {0x18, 0x24, 0x24, 0x18, 0xFC}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x24}, // pqrs
+    {0x04, 0x04, 0x3F, 0x44, 0x24}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C}, {0x3C, 0x40, 0x30, 0x40, 0x3C}, // tuvw
+    {0x44, 0x28, 0x10, 0x28, 0x44}, {0x4C, 0x90, 0x90, 0x90, 0x7C}, {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, // xyz{
+    {0x00, 0x00, 0x77, 0x00, 0x00}, {0x00, 0x41, 0x36, 0x08, 0x00}, {0x02, 0x01, 0x02, 0x04, 0x02}                                    // |}~
+};
+
+static uint16_t framebuffer[DISPLAY_HEIGHT][DISPLAY_WIDTH];
+static displaySim_stats_t stats;
+static uint8_t callDepth; // > 0 while a primitive is running, so the driver's nested calls are not counted as application calls
+
+// text state, defaults match the driver
+static int16_t cursorX, cursorY;
+static uint16_t textColor = DISPLAY_WHITE, textBgColor = DISPLAY_WHITE; // equal colors mean a transparent background
+static uint8_t textSize = 1;
+static bool textWrap = true;
+
+// touch state
+static bool touched;
+static int16_t touchX, touchY;
+static uint8_t touchZ;
+
+// helper function that counts an application call to a primitive
+static void enter(displaySim_primitive_t primitive) {
+    if (callDepth == 0)
+        stats.calls[primitive]++;
+    callDepth++;
+}
+
+static void leave() {
+    callDepth--;
+}
+
+// helper function that models one address window filled with color, clipped to the screen
+static void writeWindow(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if (x + w > DISPLAY_WIDTH)
+        w = DISPLAY_WIDTH - x;
+    if (y + h > DISPLAY_HEIGHT)
+        h = DISPLAY_HEIGHT - y;
+    if ((w <= 0) || (h <= 0)) // the driver skips windows that are entirely off the screen
+        return;
+    for (int16_t r = y; r < y + h; r++)
+        for (int16_t c = x; c < x + w; c++)
+            framebuffer[r][c] = color;
+    uint32_t pixels = (uint32_t) w * h;
+    stats.windows++;
+    stats.pixelsWritten += pixels;
+    stats.busBytes += WINDOW_BYTES + PIXEL_BYTES * pixels;
+    if (pixels == (uint32_t) DISPLAY_WIDTH * DISPLAY_HEIGHT)
+        stats.fullScreenWrites++;
+}
+
+// helper function for the quarter circle outlines of the midpoint algorithm
+static void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color) {
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        if (corners & 0x1) {
+            display_drawFastVLine(x0 + x, y0 - y, 2 * y + 1 + delta, color);
+            display_drawFastVLine(x0 + y, y0 - x, 2 * x + 1 + delta, color);
+        }
+        if (corners & 0x2) {
+            display_drawFastVLine(x0 - x, y0 - y, 2 * y + 1 + delta, color);
+            display_drawFastVLine(x0 - y, y0 - x, 2 * x + 1 + delta, color);
+        }
+    }
+}
+
+// helper function that swaps two coordinates
+static void swap(int16_t *a, int16_t *b) {
+    int16_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+void display_init() {
+    memset(framebuffer, 0, sizeof(framebuffer)); // the panel powers up black
+    cursorX = cursorY = 0;
+    textColor = textBgColor = DISPLAY_WHITE;
+    textSize = 1;
+    textWrap = true;
+    touched = false;
+}
+
+void display_fillScreen(uint16_t color) {
+    enter(DISPLAYSIM_FILL_SCREEN);
+    writeWindow(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, color);
+    leave();
+}
+
+void display_drawPixel(int16_t x, int16_t y, uint16_t color) {
+    enter(DISPLAYSIM_DRAW_PIXEL);
+    writeWindow(x, y, 1, 1, color);
+    leave();
+}
+
+// Bresenham, one window per pixel; straight lines go through the fast line calls like the driver's do
+void display_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    enter(DISPLAYSIM_DRAW_LINE);
+    if (x0 == x1) {
+        if (y0 > y1)
+            swap(&y0, &y1);
+        display_drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    } else if (y0 == y1) {
+        if (x0 > x1)
+            swap(&x0, &x1);
+        display_drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    } else {
+        bool steep = abs(y1 - y0) > abs(x1 - x0);
+        if (steep) {
+            swap(&x0, &y0);
+            swap(&x1, &y1);
+        }
+        if (x0 > x1) {
+            swap(&x0, &x1);
+            swap(&y0, &y1);
+        }
+        int16_t dx = x1 - x0;
+        int16_t dy = abs(y1 - y0);
+        int16_t err = dx / 2;
+        int16_t ystep = (y0 < y1) ? 1 : -1;
+        for (; x0 <= x1; x0++) {
+            if (steep)
+                display_drawPixel(y0, x0, color);
+            else
+                display_drawPixel(x0, y0, color);
+            err -= dy;
+            if (err < 0) {
+                y0 += ystep;
+                err += dx;
+            }
+        }
+    }
+    leave();
+}
+
+void display_drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    enter(DISPLAYSIM_DRAW_FAST_VLINE);
+    writeWindow(x, y, 1, h, color);
+    leave();
+}
+
+void display_drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    enter(DISPLAYSIM_DRAW_FAST_HLINE);
+    writeWindow(x, y, w, 1, color);
+    leave();
+}
+
+void display_drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    enter(DISPLAYSIM_DRAW_RECT);
+    display_drawFastHLine(x, y, w, color);
+    display_drawFastHLine(x, y + h - 1, w, color);
+    display_drawFastVLine(x, y, h, color);
+    display_drawFastVLine(x + w - 1, y, h, color);
+    leave();
+}
+
+void display_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    enter(DISPLAYSIM_FILL_RECT);
+    writeWindow(x, y, w, h, color);
+    leave();
+}
+
+// midpoint circle, one window per pixel
+void display_drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    enter(DISPLAYSIM_DRAW_CIRCLE);
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+    display_drawPixel(x0, y0 + r, color);
+    display_drawPixel(x0, y0 - r, color);
+    display_drawPixel(x0 + r, y0, color);
+    display_drawPixel(x0 - r, y0, color);
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        display_drawPixel(x0 + x, y0 + y, color);
+        display_drawPixel(x0 - x, y0 + y, color);
+        display_drawPixel(x0 + x, y0 - y, color);
+        display_drawPixel(x0 - x, y0 - y, color);
+        display_drawPixel(x0 + y, y0 + x, color);
+        display_drawPixel(x0 - y, y0 + x, color);
+        display_drawPixel(x0 + y, y0 - x, color);
+        display_drawPixel(x0 - y, y0 - x, color);
+    }
+    leave();
+}
+
+void display_fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    enter(DISPLAYSIM_FILL_CIRCLE);
+    display_drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+    fillCircleHelper(x0, y0, r, 0x3, 0, color);
+    leave();
+}
+
+void display_drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    enter(DISPLAYSIM_DRAW_TRIANGLE);
+    display_drawLine(x0, y0, x1, y1, color);
+    display_drawLine(x1, y1, x2, y2, color);
+    display_drawLine(x2, y2, x0, y0, color);
+    leave();
+}
+
+// scanline fill, one horizontal line per row
+void display_fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    enter(DISPLAYSIM_FILL_TRIANGLE);
+    if (y0 > y1) { // sort the corners by y
+        swap(&y0, &y1);
+        swap(&x0, &x1);
+    }
+    if (y1 > y2) {
+        swap(&y2, &y1);
+        swap(&x2, &x1);
+    }
+    if (y0 > y1) {
+        swap(&y0, &y1);
+        swap(&x0, &x1);
+    }
+    if (y0 == y2) { // all on one row
+        int16_t a = x0, b = x0;
+        if (x1 < a)
+            a = x1;
+        else if (x1 > b)
+            b = x1;
+        if (x2 < a)
+            a = x2;
+        else if (x2 > b)
+            b = x2;
+        display_drawFastHLine(a, y0, b - a + 1, color);
+        leave();
+        return;
+    }
+    int32_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+    int16_t last = (y1 == y2) ? y1 : y1 - 1; // include row y1 in the upper half only if the bottom is flat
+    int16_t y;
+    for (y = y0; y <= last; y++) {
+        int16_t a = x0 + sa / dy01;
+        int16_t b = x0 + sb / dy02;
+        sa += dx01;
+        sb += dx02;
+        if (a > b)
+            swap(&a, &b);
+        display_drawFastHLine(a, y, b - a + 1, color);
+    }
+    sa = dx12 * (y - y1);
+    sb = dx02 * (y - y0);
+    for (; y <= y2; y++) {
+        int16_t a = x1 + sa / dy12;
+        int16_t b = x0 + sb / dy02;
+        sa += dx12;
+        sb += dx02;
+        if (a > b)
+            swap(&a, &b);
+        display_drawFastHLine(a, y, b - a + 1, color);
+    }
+    leave();
+}
+
+// set font pixels are drawn in color; clear ones in bg unless bg == color (transparent)
+void display_drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+    if ((x >= DISPLAY_WIDTH) || (y >= DISPLAY_HEIGHT) || (x + CHAR_COLUMNS * size - 1 < 0) || (y + CHAR_ROWS * size - 1 < 0))
+        return;
+    enter(DISPLAYSIM_DRAW_CHAR);
+    if ((c < FONT_FIRST_CHAR) || (c > FONT_LAST_CHAR)) // characters outside the table draw as blanks
+        c = FONT_FIRST_CHAR;
+    for (int8_t i = 0; i < CHAR_COLUMNS; i++) {
+        uint8_t line = (i == FONT_COLUMNS) ? 0 : font[c - FONT_FIRST_CHAR][i];
+        for (int8_t j = 0; j < CHAR_ROWS; j++, line >>= 1) {
+            uint16_t pixelColor;
+            if (line & 0x1)
+                pixelColor = color;
+            else if (bg != color)
+                pixelColor = bg;
+            else
+                continue;
+            if (size == 1)
+                display_drawPixel(x + i, y + j, pixelColor);
+            else
+                display_fillRect(x + (i * size), y + (j * size), size, size, pixelColor);
+        }
+    }
+    leave();
+}
+
+void display_setCursor(int16_t x, int16_t y) {
+    cursorX = x;
+    cursorY = y;
+}
+
+void display_setTextColor(uint16_t c) {
+    textColor = textBgColor = c;
+}
+
+void display_setTextColorBg(uint16_t c, uint16_t bg) {
+    textColor = c;
+    textBgColor = bg;
+}
+
+void display_setTextSize(uint8_t s) {
+    textSize = (s > 0) ? s : 1;
+}
+
+void display_setTextWrap(bool w) {
+    textWrap = w;
+}
+
+void display_printChar(char c) {
+    if (c == '\n') {
+        cursorY += textSize * CHAR_ROWS;
+        cursorX = 0;
+    } else if (c != '\r') {
+        display_drawChar(cursorX, cursorY, c, textColor, textBgColor, textSize);
+        cursorX += textSize * CHAR_COLUMNS;
+        if (textWrap && (cursorX > (DISPLAY_WIDTH - textSize * CHAR_COLUMNS))) {
+            cursorY += textSize * CHAR_ROWS;
+            cursorX = 0;
+        }
+    }
+}
+
+void display_print(const char *str) {
+    while (*str)
+        display_printChar(*str++);
+}
+
+void display_println(const char *str) {
+    display_print(str);
+    display_printChar('\n');
+}
+
+bool display_isTouched(void) {
+    return touched;
+}
+
+void display_clearOldTouchData(void) {
+}
+
+void display_getTouchedPoint(int16_t *x, int16_t *y, uint8_t *z) {
+    *x = touchX;
+    *y = touchY;
+    *z = touchZ;
+}
+
+// Returns the counts since the last reset.
+displaySim_stats_t displaySim_getStats() {
+    return stats;
+}
+
+// Zeroes all counts. The framebuffer is left alone.
+void displaySim_resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Prints the counts on stdout.
+void displaySim_printStats() {
+    static const char *names[DISPLAYSIM_NUM_OF_PRIMITIVES] = {"fillScreen", "drawPixel", "drawLine", "drawFastVLine", "drawFastHLine", "drawRect", "fillRect", "drawCircle", "fillCircle", "drawTriangle", "fillTriangle", "drawChar"};
+    for (uint8_t i = 0; i < DISPLAYSIM_NUM_OF_PRIMITIVES; i++)
+        if (stats.calls[i])
+            printf("%-14s %8lu calls\n", names[i], (unsigned long) stats.calls[i]);
+    printf("%llu pixels, %lu windows, %llu bus bytes, %lu full screen writes\n", (unsigned long long) stats.pixelsWritten, (unsigned long) stats.windows, (unsigned long long) stats.busBytes, (unsigned long) stats.fullScreenWrites);
+}
+
+// Returns the RGB565 color of one pixel (0 if off the screen).
+uint16_t displaySim_getPixel(int16_t x, int16_t y) {
+    if ((x < 0) || (y < 0) || (x >= DISPLAY_WIDTH) || (y >= DISPLAY_HEIGHT))
+        return 0;
+    return framebuffer[y][x];
+}
+
+// Writes the framebuffer to fileName as a binary PPM (P6) image.
+// Returns false if the file could not be written.
+bool displaySim_writePpm(const char *fileName) {
+    FILE *file = fopen(fileName, "wb");
+    if (!file)
+        return false;
+    fprintf(file, "P6\n%d %d\n%d\n", DISPLAY_WIDTH, DISPLAY_HEIGHT, PPM_MAX_VALUE);
+    for (int16_t r = 0; r < DISPLAY_HEIGHT; r++) {
+        for (int16_t c = 0; c < DISPLAY_WIDTH; c++) {
+            uint16_t color = framebuffer[r][c];
+            uint8_t rgb[3] = {((color >> RGB565_RED_SHIFT) & RGB565_5_BIT_MASK) * PPM_MAX_VALUE / RGB565_5_BIT_MASK, ((color >> RGB565_GREEN_SHIFT) & RGB565_6_BIT_MASK) * PPM_MAX_VALUE / RGB565_6_BIT_MASK, (color & RGB565_5_BIT_MASK) * PPM_MAX_VALUE / RGB565_5_BIT_MASK};
+            fwrite(rgb, sizeof(rgb), 1, file);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+// Presses the touch screen at (x, y) with pressure z, or lets go of it.
+void displaySim_touch(int16_t x, int16_t y, uint8_t z) {
+    touched = true;
+    touchX = x;
+    touchY = y;
+    touchZ = z;
+}
+
+void displaySim_release() {
+    touched = false;
+}
@@ -0,0 +1,62 @@
+#ifndef DISPLAYSIM_H_
+#define DISPLAYSIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Headless host implementation of the display.h API. displaySim.c replaces
+// the board's display driver when the rendering code is compiled on a Linux
+// machine, e.g.
+//   gcc -I. displaySim.c clockDisplay.c clockTime.c ... main_host.c
+// Every draw lands in an in-memory RGB565 framebuffer and is counted: pixels
+// written, calls per display.h primitive and the bytes the same calls would
+// put on the LCD bus (an 11 byte address window per window the driver opens
+// plus 2 bytes per pixel, the model displayBuffer uses). Snapshots of the
+// framebuffer can be written as PPM images, and touches can be injected.
+
+// display.h entry points that are counted separately
+typedef enum {
+    DISPLAYSIM_FILL_SCREEN,
+    DISPLAYSIM_DRAW_PIXEL,
+    DISPLAYSIM_DRAW_LINE,
+    DISPLAYSIM_DRAW_FAST_VLINE,
+    DISPLAYSIM_DRAW_FAST_HLINE,
+    DISPLAYSIM_DRAW_RECT,
+    DISPLAYSIM_FILL_RECT,
+    DISPLAYSIM_DRAW_CIRCLE,
+    DISPLAYSIM_FILL_CIRCLE,
+    DISPLAYSIM_DRAW_TRIANGLE,
+    DISPLAYSIM_FILL_TRIANGLE,
+    DISPLAYSIM_DRAW_CHAR,
+    DISPLAYSIM_NUM_OF_PRIMITIVES
+} displaySim_primitive_t;
+
+typedef struct {
+    uint32_t calls[DISPLAYSIM_NUM_OF_PRIMITIVES]; // calls made by the application, not the driver's own nested calls
+    uint64_t pixelsWritten; // pixels sent, counting a pixel again each time it is overwritten
+    uint64_t busBytes; // estimated LCD bus bytes
+    uint32_t windows; // address windows opened
+    uint32_t fullScreenWrites; // single writes that covered the whole screen
+} displaySim_stats_t;
+
+// Returns the counts since the last reset.
+displaySim_stats_t displaySim_getStats();
+
+// Zeroes all counts. The framebuffer is left alone.
+void displaySim_resetStats();
+
+// Prints the counts on stdout.
+void displaySim_printStats();
+
+// Returns the RGB565 color of one pixel (0 if off the screen).
+uint16_t displaySim_getPixel(int16_t x, int16_t y);
+
+// Writes the framebuffer to fileName as a binary PPM (P6) image.
+// Returns false if the file could not be written.
+bool displaySim_writePpm(const char *fileName);
+
+// Presses the touch screen at (x, y) with pressure z, or lets go of it.
+void displaySim_touch(int16_t x, int16_t y, uint8_t z);
+void displaySim_release();
+
+#endif /* DISPLAYSIM_H_ */
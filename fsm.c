@@ -0,0 +1,72 @@
+#include "fsm.h"
+#include "intervalTimer.h"
+
+#include <stdio.h>
+
+// helper function that takes the transition: exit, mealy action, entry
+static void takeTransition(fsm_t *fsm, const fsm_state_t *from, const fsm_transition_t *transition) {
+    if (from->exit)
+        from->exit();
+    if (transition->action)
+        transition->action();
+    fsm->currentState = transition->target;
+    const fsm_state_t *to = &fsm->machine->states[transition->target];
+    if (to->entry)
+        to->entry();
+}
+
+// Puts fsm in the machine's initial state.
+void fsm_init(fsm_t *fsm, const fsm_machine_t *machine) {
+    fsm->machine = machine;
+    fsm->currentState = machine->initialState;
+    fsm->hook = NULL;
+    fsm->timer = 0;
+}
+
+// Takes at most one transition and runs the tick action of the resulting state.
+uint8_t fsm_tick(fsm_t *fsm) {
+    const fsm_machine_t *machine = fsm->machine;
+    uint8_t fromState = fsm->currentState;
+    if (fromState >= machine->stateCount) {
+        printf("ERROR\n"); // print an error message if the state machine is not in one of the defined states
+        return fromState;
+    }
+
+    const fsm_state_t *state = &machine->states[fromState];
+    uint8_t index = state->select ? state->select() : 0;
+    if (index < state->transitionCount) { // FSM_STAY is never a valid index
+        const fsm_transition_t *transition = &state->transitions[index];
+        if (fsm->hook) { // time the transition only when someone is listening
+            uint64_t start = timestamp_read(fsm->timer);
+            takeTransition(fsm, state, transition);
+            fsm->hook(fsm, fromState, fsm->currentState, (uint32_t) (timestamp_read(fsm->timer) - start));
+        }
+        else
+            takeTransition(fsm, state, transition);
+        state = &machine->states[fsm->currentState];
+    }
+
+    if (state->tick)
+        state->tick();
+    return fromState;
+}
+
+// Installs a transition hook, or removes it with NULL.
+void fsm_setHook(fsm_t *fsm, fsm_hook_t hook) {
+    if (hook && !fsm->timer)
+        fsm->timer = timestamp_startTimer(FSM_TIMER);
+    fsm->hook = hook;
+}
+
+// Prints every transition with its duration.
+void fsm_printTransition(const fsm_t *fsm, uint8_t fromState, uint8_t toState, uint32_t ticks) {
+    const char *const *names = fsm->machine->stateNames;
+    printf("%s: %s -> %s (%lu us)\n", fsm->machine->name, names[fromState], names[toState], (unsigned long) timestamp_toMicroseconds(ticks));
+}
+
+// Returns the name of the current state.
+const char *fsm_getStateName(const fsm_t *fsm) {
+    if (fsm->currentState >= fsm->machine->stateCount)
+        return "?";
+    return fsm->machine->stateNames[fsm->currentState];
+}
@@ -0,0 +1,90 @@
+#ifndef FSM_H_
+#define FSM_H_
+
+#include "timestamp.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Table-driven state machine engine. A machine is a const table of states;
+// each state has a row of transitions, each with a mealy action and a
+// target, and a select function that returns the index of the transition
+// to take this tick, or FSM_STAY. States have entry, exit and tick (moore)
+// actions. Any of the function pointers may be NULL; a NULL select always
+// takes transition 0, for states that leave unconditionally.
+//
+// Every tick looks up the current state by index, calls its select function
+// once and indexes straight into its row - no scan over guards - takes that
+// transition (exit, transition action, entry), then runs the tick action of
+// the state it ended up in. That is the transition switch followed by the
+// action switch of the hand-written tick functions, with one indexed lookup
+// in place of the two switches; the select function is the old case of the
+// transition switch, so its tests compile inline as they did there.
+//
+// The tables are const so they stay in flash; all that changes at run time
+// is the small fsm_t.
+
+#define FSM_TIMER INTERVAL_TIMER_TIMER_1 // only read, to time transitions for the hook
+
+#define FSM_STAY 0xFF // returned by a select function to take no transition
+
+typedef uint8_t (*fsm_select_t)(); // returns an index into the state's transitions, or FSM_STAY
+typedef void (*fsm_action_t)();
+
+typedef struct {
+    fsm_action_t action; // mealy action, runs between exit and entry
+    uint8_t target;
+} fsm_transition_t;
+
+typedef struct {
+    fsm_select_t select; // NULL always takes transition 0
+    fsm_action_t entry; // runs once on every transition into the state
+    fsm_action_t tick;  // runs on every tick that ends in the state
+    fsm_action_t exit;  // runs once on every transition out of the state
+    const fsm_transition_t *transitions;
+    uint8_t transitionCount;
+} fsm_state_t;
+
+// fills in the transitions and transitionCount of a state from an array
+#define FSM_TRANSITIONS(table) table, sizeof(table) / sizeof(table[0])
+
+typedef struct {
+    const char *name;
+    const fsm_state_t *states;
+    const char *const *stateNames; // stateNames[i] names states[i]
+    uint8_t stateCount;
+    uint8_t initialState;
+} fsm_machine_t;
+
+typedef struct fsm fsm_t;
+
+// Called after every transition with the states it went between and the
+// timer ticks the exit, transition and entry actions took.
+typedef void (*fsm_hook_t)(const fsm_t *fsm, uint8_t fromState, uint8_t toState, uint32_t ticks);
+
+struct fsm {
+    const fsm_machine_t *machine;
+    uint8_t currentState;
+    fsm_hook_t hook;
+    timestamp_handle_t timer; // only set while a hook is installed
+};
+
+// Puts fsm in the machine's initial state without running its entry action,
+// like setting currentState in the old init functions. Removes any hook.
+void fsm_init(fsm_t *fsm, const fsm_machine_t *machine);
+
+// Takes at most one transition and runs the tick action of the resulting
+// state. Returns the state the tick started in.
+uint8_t fsm_tick(fsm_t *fsm);
+
+// Installs a transition hook, or removes it with NULL. Installing one starts
+// FSM_TIMER if nothing else has.
+void fsm_setHook(fsm_t *fsm, fsm_hook_t hook);
+
+// A ready-made hook that prints every transition with its duration.
+void fsm_printTransition(const fsm_t *fsm, uint8_t fromState, uint8_t toState, uint32_t ticks);
+
+// Returns the name of the current state.
+const char *fsm_getStateName(const fsm_t *fsm);
+
+#endif /* FSM_H_ */
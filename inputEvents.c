@@ -0,0 +1,152 @@
+#include "inputEvents.h"
+#include "buttons.h"
+#include "intervalTimer.h"
+#include "switches.h"
+#include "timestamp.h"
+#include "xil_exception.h"
+#include "xil_io.h"
+#include "xparameters.h"
+
+#include <stdio.h>
+
+#define GPIO_GLOBAL_INTERRUPT_OFFSET 0x11C
+#define GPIO_INTERRUPT_STATUS_OFFSET 0x120 // write a 1 to clear a bit
+#define GPIO_INTERRUPT_ENABLE_OFFSET 0x128
+#define GPIO_GLOBAL_INTERRUPT_DISABLE 0x0
+#define GPIO_CHANNEL_1_INTERRUPT 0x1
+#define NUM_OF_SOURCES 2
+#define RING_MASK (INPUTEVENTS_SIZE - 1)
+#define PERMILLE 1000
+
+// the WFI instruction; sleeps until an interrupt is pending, even a masked one
+#ifndef INPUTEVENTS_WAIT_FOR_INTERRUPT
+#define INPUTEVENTS_WAIT_FOR_INTERRUPT() __asm__ volatile("wfi")
+#endif
+
+static const uint32_t baseAddresses[NUM_OF_SOURCES] = {XPAR_PUSH_BUTTONS_BASEADDR, XPAR_SLIDE_SWITCHES_BASEADDR};
+
+static inputEvents_event_t ring[INPUTEVENTS_SIZE];
+static volatile uint16_t head; // moved only by the poll
+static volatile uint16_t tail; // moved only by the consumer
+static volatile uint8_t values[NUM_OF_SOURCES];
+static volatile bool interruptRunning; // set by the first poll from the timer interrupt
+static timestamp_handle_t timer;
+
+static volatile uint32_t eventCount;
+static volatile uint32_t droppedCount;
+static uint64_t idleTicks;
+static uint64_t startTicks;
+
+// helper function that reads one GPIO's data register
+static uint8_t readSource(uint8_t source) {
+    return (source == INPUTEVENTS_BUTTONS) ? buttons_read() : switches_read();
+}
+
+// Turns on change latching in both GPIOs, reads their values and empties the ring.
+void inputEvents_init() {
+    if (!INPUTEVENTS_ENABLED)
+        return;
+    timer = timestamp_startTimer(INPUTEVENTS_TIMER);
+    for (uint8_t source = 0; source < NUM_OF_SOURCES; source++) {
+        uint32_t base = baseAddresses[source];
+        values[source] = readSource(source);
+        Xil_Out32(base + GPIO_INTERRUPT_STATUS_OFFSET, GPIO_CHANNEL_1_INTERRUPT); // forget any edge from before
+        Xil_Out32(base + GPIO_INTERRUPT_ENABLE_OFFSET, GPIO_CHANNEL_1_INTERRUPT);
+        Xil_Out32(base + GPIO_GLOBAL_INTERRUPT_OFFSET, GPIO_GLOBAL_INTERRUPT_DISABLE); // latch only, no handler is connected to the line
+    }
+    head = 0;
+    tail = 0;
+    eventCount = 0;
+    droppedCount = 0;
+    idleTicks = 0;
+    startTicks = timestamp_read(timer);
+}
+
+// helper function that picks up the edges the GPIOs have latched, with interrupts off or from the tick
+static void collectEdges() {
+    for (uint8_t source = 0; source < NUM_OF_SOURCES; source++) {
+        uint32_t base = baseAddresses[source];
+        if (!(Xil_In32(base + GPIO_INTERRUPT_STATUS_OFFSET) & GPIO_CHANNEL_1_INTERRUPT))
+            continue; // nothing changed, one register read and done
+        Xil_Out32(base + GPIO_INTERRUPT_STATUS_OFFSET, GPIO_CHANNEL_1_INTERRUPT); // clear before reading so a later edge isn't lost
+        uint8_t value = readSource(source);
+        uint8_t changed = value ^ values[source];
+        if (!changed)
+            continue; // a bounce that came back before we looked
+        values[source] = value;
+        eventCount++;
+        if ((uint16_t) (head - tail) == INPUTEVENTS_SIZE) { // full: the values stay right, only the edge is lost
+            droppedCount++;
+            continue;
+        }
+        inputEvents_event_t *event = &ring[head & RING_MASK];
+        event->source = source;
+        event->value = value;
+        event->changed = changed;
+        event->timestamp = timestamp_read(timer);
+        __sync_synchronize(); // the slot is written before the consumer can see it
+        head++;
+    }
+}
+
+// Picks up the edges the GPIOs have latched.
+void inputEvents_poll() {
+    if (!INPUTEVENTS_ENABLED)
+        return;
+    interruptRunning = true;
+    collectEdges();
+}
+
+// Take the oldest event, returning false if there is none.
+bool inputEvents_pop(inputEvents_event_t *event) {
+    if (tail == head)
+        return false;
+    *event = ring[tail & RING_MASK];
+    __sync_synchronize(); // the slot is copied before the poll may reuse it
+    tail++;
+    return true;
+}
+
+// Drops every event that is waiting.
+void inputEvents_flush() {
+    tail = head;
+}
+
+// The last value seen on the buttons.
+int32_t inputEvents_getButtons() {
+    return INPUTEVENTS_ENABLED ? values[INPUTEVENTS_BUTTONS] : buttons_read();
+}
+
+// The last value seen on the switches.
+int32_t inputEvents_getSwitches() {
+    return INPUTEVENTS_ENABLED ? values[INPUTEVENTS_SWITCHES] : switches_read();
+}
+
+// Sleeps until the next interrupt unless events are waiting or ready returns true.
+void inputEvents_idle(bool (*ready)()) {
+    if (!INPUTEVENTS_ENABLED)
+        return;
+    Xil_ExceptionDisable(); // anything that wakes us from here on stays pending until WFI
+    if (!interruptRunning) // nothing would wake us or collect the edges, so poll the GPIOs instead of sleeping
+        collectEdges();
+    else if ((tail == head) && !(ready && ready())) {
+        uint64_t start = timestamp_read(timer);
+        INPUTEVENTS_WAIT_FOR_INTERRUPT();
+        idleTicks += timestamp_read(timer) - start;
+    }
+    Xil_ExceptionEnable(); // the interrupt that woke us runs here
+}
+
+// Returns true once the timer interrupt is running.
+bool inputEvents_isInterruptRunning() {
+    return interruptRunning;
+}
+
+// Prints events, drops and idle time.
+void inputEvents_printStats() {
+    if (!INPUTEVENTS_ENABLED)
+        return;
+    uint64_t elapsed = timestamp_read(timer) - startTicks;
+    uint32_t idle = elapsed ? (uint32_t) (idleTicks * PERMILLE / elapsed) : 0;
+    printf("inputEvents: %lu events, %lu dropped, idle %lu.%lu%%\n", (unsigned long) eventCount, (unsigned long) droppedCount, (unsigned long) idle / 10, (unsigned long) idle % 10);
+}
@@ -0,0 +1,70 @@
+#ifndef INPUTEVENTS_H_
+#define INPUTEVENTS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Tick-polled edge capture for the push buttons and slide switches. Both
+// AXI GPIOs latch every change in their interrupt status register, but their
+// interrupt output stays off: the course interrupt setup has no handler for
+// those lines. Instead inputEvents_poll, called from isr_function on every
+// timer tick, reads a GPIO only if it latched something, keeps its value and
+// puts an edge event into a lock-free single producer / single consumer ring.
+// An edge is therefore seen up to one tick after it happens, but a press
+// shorter than a tick is still latched and not lost. Consumers read the kept
+// values or take the events instead of reading the GPIOs, and sleep with WFI
+// between ticks.
+//
+// Until the first tick has come in, inputEvents_idle doesn't sleep; it
+// collects the latched edges itself and returns, so code that waits on input
+// also works before (or without) the timer interrupt. With
+// INPUTEVENTS_ENABLED set to 0 the values are read from the GPIOs, no events
+// come in and nothing sleeps, which is the old polling behavior.
+
+#define INPUTEVENTS_ENABLED 0
+#define INPUTEVENTS_SIZE 32 // must be a power of two
+#define INPUTEVENTS_TIMER INTERVAL_TIMER_TIMER_1 // only read, shared with the timer wheel and the scheduler
+
+#define INPUTEVENTS_BUTTONS 0
+#define INPUTEVENTS_SWITCHES 1
+
+typedef struct {
+    uint8_t source; // INPUTEVENTS_BUTTONS or INPUTEVENTS_SWITCHES
+    uint8_t value; // every bit of the GPIO after the edge
+    uint8_t changed; // the bits that changed
+    uint64_t timestamp; // timer ticks when the poll picked it up
+} inputEvents_event_t;
+
+// Turns on change latching in both GPIOs, reads their values and empties
+// the ring. Call after buttons_init and switches_init.
+void inputEvents_init();
+
+// Picks up the edges the GPIOs have latched. Call from the timer interrupt.
+void inputEvents_poll();
+
+// Take the oldest event, returning false if there is none. Only one
+// consumer may take events: inputSnapshot_update.
+bool inputEvents_pop(inputEvents_event_t *event);
+
+// Drops every event that is waiting.
+void inputEvents_flush();
+
+// The last value seen on each GPIO, without a bus read when events are on.
+int32_t inputEvents_getButtons();
+int32_t inputEvents_getSwitches();
+
+// Sleeps until the next interrupt unless events are waiting or ready (if
+// not NULL) returns true. ready is checked with interrupts off, so nothing
+// that an interrupt makes ready can be slept through. Before the first
+// timer interrupt it collects the latched edges and returns instead.
+void inputEvents_idle(bool (*ready)());
+
+// Returns true once the timer interrupt is running, so sleeping until the
+// next interrupt will wake up.
+bool inputEvents_isInterruptRunning();
+
+// Prints events, drops and idle time.
+void inputEvents_printStats();
+
+#endif /* INPUTEVENTS_H_ */
@@ -0,0 +1,121 @@
+#include "inputSnapshot.h"
+#include "inputEvents.h"
+#include "intervalTimer.h"
+#include "timestamp.h"
+
+#define SWITCHES_SHIFT 8
+#define TICKS_PER_SAMPLE ((uint32_t) (TIMESTAMP_TICKS_PER_SECOND / 1000 * INPUTSNAPSHOT_SAMPLE_MS))
+
+static timestamp_handle_t timer;
+static uint64_t lastSampleTicks;
+static uint16_t state; // debounced levels
+static uint16_t count0; // low bit of every input's counter
+static uint16_t count1; // high bit of every input's counter
+static uint16_t delta; // inputs whose last sample disagreed with state
+static uint16_t pressed;
+static uint16_t released;
+static uint16_t levels; // raw inputs as of the last edge replayed, the next samples read these
+
+// helper function that reads the buttons and switches once each
+static uint16_t readLevels() {
+    return INPUTSNAPSHOT_BUTTONS(inputEvents_getButtons()) | INPUTSNAPSHOT_SWITCHES(inputEvents_getSwitches());
+}
+
+// Takes the current inputs as settled, with no edges.
+void inputSnapshot_init() {
+    timer = timestamp_startTimer(INPUTSNAPSHOT_TIMER);
+    lastSampleTicks = timestamp_read(timer);
+    inputEvents_flush(); // edges from before now are already in the levels
+    state = readLevels();
+    levels = state;
+    count0 = 0xFFFF; // every counter at rest
+    count1 = 0xFFFF;
+    delta = 0;
+    pressed = 0;
+    released = 0;
+}
+
+// helper function that debounces one sample of the raw inputs
+static void sample() {
+    delta = levels ^ state;
+    // count down every disagreeing input from 3 to 0 and back to 3, all
+    // sixteen at once; agreeing inputs go back to 3
+    count0 = ~(count0 & delta);
+    count1 = count0 ^ (count1 & delta);
+    uint16_t toggle = delta & count0 & count1; // wrapped around: disagreed INPUTSNAPSHOT_STABLE_SAMPLES times
+    state ^= toggle;
+    delta &= ~toggle;
+    pressed |= toggle & state;
+    released |= toggle & ~state;
+}
+
+// helper function that takes every sample due before ticks, reading the current levels
+static void sampleUntil(uint64_t ticks) {
+    while (ticks >= lastSampleTicks + TICKS_PER_SAMPLE) {
+        lastSampleTicks += TICKS_PER_SAMPLE;
+        sample();
+        if (!delta) { // settled: more samples of the same levels change nothing
+            lastSampleTicks = ticks - (ticks - lastSampleTicks) % TICKS_PER_SAMPLE;
+            return;
+        }
+    }
+}
+
+// Takes the samples due since the last call, replaying the edges in between.
+void inputSnapshot_update() {
+    if (!INPUTEVENTS_ENABLED) { // nothing is known between two reads, so at most one sample per call
+        uint64_t now = timestamp_read(timer);
+        if (now - lastSampleTicks < TICKS_PER_SAMPLE)
+            return;
+        lastSampleTicks = now;
+        levels = readLevels();
+        sample();
+        return;
+    }
+    inputEvents_event_t event;
+    while (inputEvents_pop(&event)) { // each edge takes effect at the sample after it, however late this runs
+        sampleUntil(event.timestamp);
+        uint16_t mask = (event.source == INPUTEVENTS_BUTTONS) ? INPUTSNAPSHOT_BUTTONS(0xFF) : INPUTSNAPSHOT_SWITCHES(0xFF);
+        uint16_t value = (event.source == INPUTEVENTS_BUTTONS) ? INPUTSNAPSHOT_BUTTONS(event.value) : INPUTSNAPSHOT_SWITCHES(event.value);
+        levels = (levels & ~mask) | value;
+    }
+    levels = readLevels(); // the kept values, right even if the ring dropped an edge
+    sampleUntil(timestamp_read(timer));
+}
+
+// Returns the debounced levels and the edges since the last call.
+inputSnapshot_t inputSnapshot_get() {
+    inputSnapshot_t snapshot = {state, pressed, released};
+    pressed = 0;
+    released = 0;
+    return snapshot;
+}
+
+// Returns the debounced levels, leaving the edges alone.
+uint16_t inputSnapshot_getHeld() {
+    return state;
+}
+
+// Clears the edges without looking at them.
+void inputSnapshot_flush() {
+    pressed = 0;
+    released = 0;
+}
+
+// Returns true while some input disagrees with its debounced level.
+bool inputSnapshot_isSettling() {
+    return delta != 0;
+}
+
+// Sleeps until the snapshot changes or an input starts settling.
+void inputSnapshot_wait() {
+    if (delta) { // settling: the next sample is due after the next timer interrupt
+        inputEvents_idle(NULL);
+        return;
+    }
+    uint16_t edges = pressed | released;
+    while (!delta && ((pressed | released) == edges)) { // idle returns right away while edges wait for the update
+        inputEvents_idle(NULL);
+        inputSnapshot_update();
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef INPUTSNAPSHOT_H_
+#define INPUTSNAPSHOT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Debounced snapshot of the push buttons and slide switches. Each sample
+// reads the buttons and the switches once and debounces every bit at once
+// with a two-bit vertical counter: an input only changes after
+// INPUTSNAPSHOT_STABLE_SAMPLES samples in a row disagree with it. Consumers
+// get the debounced levels together with the edges since their last look,
+// so every test in a pass sees the same values.
+//
+// With INPUTEVENTS_ENABLED the samples are taken on a fixed
+// INPUTSNAPSHOT_SAMPLE_MS grid no matter how often inputSnapshot_update is
+// called: it takes the input events off the ring and replays each edge at the
+// sample it fell in, so a press that comes and goes between two updates of a
+// slow state machine is still debounced and reported. Without events each
+// update takes at most one sample of the levels it reads.
+//
+// Buttons are in the low byte and switches in the high byte; use the macros
+// below to build masks.
+
+#define INPUTSNAPSHOT_SAMPLE_MS 10 // samples closer together than this are skipped
+#define INPUTSNAPSHOT_STABLE_SAMPLES 4 // fixed by the two-bit counters
+#define INPUTSNAPSHOT_TIMER INTERVAL_TIMER_TIMER_1 // only read, shared with the timer wheel and the scheduler
+
+#define INPUTSNAPSHOT_BUTTONS(mask) ((uint16_t) (mask))
+#define INPUTSNAPSHOT_SWITCHES(mask) ((uint16_t) ((mask) << 8))
+#define INPUTSNAPSHOT_GET_BUTTONS(bits) ((uint8_t) (bits))
+#define INPUTSNAPSHOT_GET_SWITCHES(bits) ((uint8_t) ((bits) >> 8))
+
+typedef struct {
+    uint16_t held; // debounced level of every input
+    uint16_t pressed; // inputs that turned on since the last inputSnapshot_get
+    uint16_t released; // inputs that turned off since the last inputSnapshot_get
+} inputSnapshot_t;
+
+// Takes the current inputs as settled, with no edges.
+void inputSnapshot_init();
+
+// Takes the samples due since the last call, or with events off one sample
+// if INPUTSNAPSHOT_SAMPLE_MS have passed. Takes every input event; call once
+// per tick or loop pass, from one context only.
+void inputSnapshot_update();
+
+// Returns the debounced levels and the edges since the last call, then
+// clears the edges. Edges go to one consumer.
+inputSnapshot_t inputSnapshot_get();
+
+// Returns the debounced levels, leaving the edges alone.
+uint16_t inputSnapshot_getHeld();
+
+// Clears the edges without looking at them.
+void inputSnapshot_flush();
+
+// Returns true while some input disagrees with its debounced level, i.e.
+// more samples are needed before it settles.
+bool inputSnapshot_isSettling();
+
+// Sleeps until a sample could change the snapshot: while an input is
+// settling, until the next interrupt; once everything has settled, until an
+// input starts settling or an edge comes in, updating as it goes. Sleeping
+// needs INPUTEVENTS_ENABLED and the timer interrupt running; without them
+// this polls the GPIOs until something differs or returns right away while
+// settling.
+void inputSnapshot_wait();
+
+#endif /* INPUTSNAPSHOT_H_ */
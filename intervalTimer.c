@@ -1,20 +1,33 @@
 #include "intervalTimer.h"
+#include "timestamp.h"
 #include "xparameters.h"
 #include "xil_io.h"
 
+#include <stdbool.h>
+#include <stdio.h>
+
 #define CLEAR_REGISTER 0x0
 #define TCSR0_OFFSET 0x0
 #define TCSR1_OFFSET 0x10
 #define TLR0_OFFSET 0x04
 #define TRL1_OFFSET 0x14
-#define TCR0_OFFSET 0x08
-#define TCR1_OFFSET 0x18
 #define CASC_MASK 0x0800
 #define UDT0_MASK 0x0002
 #define ENT0_MASK 0x0080
 #define LOAD_MASK 0x0020
-#define TIMER_WIDTH 32
-#define TIMER_NUMBER_INVALID 0
+#define NUM_OF_TIMERS 3
+#define NO_BITS 0x0
+
+// Keep software copies of TCSR0/TCSR1 so control bits are changed with a
+// single write and no read. Nothing else writes these registers and the bits
+// we use are never changed by the hardware, so the copies stay exact.
+#define SHADOW_REGISTERS true
+// Debug mode: read each control register back after writing it and report
+// any difference from its shadow copy.
+#define VERIFY_SHADOW_REGISTERS false
+
+static uint32_t tcsr0Shadow[NUM_OF_TIMERS];
+static uint32_t tcsr1Shadow[NUM_OF_TIMERS];
 
 // Helper function to read from registers.
 // The argument baseAddress gives base address and the 
@@ -32,23 +45,25 @@ void intervalTimer_writeRegister(int32_t baseAddress, int32_t offset, int32_t va
     Xil_Out32((baseAddress + offset), value); // uses the provided Xilinx function to write to the register
 }
 
+// Helper function that sets and clears bits in a control register through its
+// shadow copy: one write, and a read back only in verify mode.
+// Returns true unless verify mode found the register different from the shadow.
+static bool updateControlRegister(uint32_t baseAddress, int32_t offset, uint32_t *shadow, uint32_t setMask, uint32_t clearMask) {
+    *shadow = (*shadow | setMask) & ~clearMask;
+    intervalTimer_writeRegister(baseAddress, offset, *shadow);
+    if (VERIFY_SHADOW_REGISTERS && ((uint32_t) intervalTimer_readRegister(baseAddress, offset) != *shadow)) {
+        printf("intervalTimer: register 0x%08lx is 0x%08lx, shadow says 0x%08lx\n", (unsigned long) (baseAddress + offset), (unsigned long) intervalTimer_readRegister(baseAddress, offset), (unsigned long) *shadow);
+        return false;
+    }
+    return true;
+}
+
 // Helper function to get the base address for one of the three timers.
 // The integer returned is the base address for whichever timer number was given as the argument.
 // The timerNumber argument specifies which timer's address will be returned.
 // If the argument given is not one of the three timers, returns 0.
 uint32_t intervalTimer_getBaseAddress(uint32_t timerNumber) {
-    uint32_t baseAddress;
-
-    if (timerNumber == INTERVAL_TIMER_TIMER_0)
-        baseAddress = XPAR_AXI_TIMER_0_BASEADDR;
-    else if (timerNumber == INTERVAL_TIMER_TIMER_1)
-        baseAddress = XPAR_AXI_TIMER_1_BASEADDR;
-    else if (timerNumber == INTERVAL_TIMER_TIMER_2)
-        baseAddress = XPAR_AXI_TIMER_2_BASEADDR;
-    else
-        baseAddress = TIMER_NUMBER_INVALID;
-
-    return baseAddress;
+    return timestamp_getHandle(timerNumber); // a table lookup, the handle is the base address
 }
 
 // You must initialize the timers before you use them the first time.
@@ -61,6 +76,14 @@ intervalTimer_status_t intervalTimer_init(uint32_t timerNumber) {
     if (baseAddress == 0) // if the timerNumber argument was invalid, return INTERVAL_TIMER_STATUS_FAIL
         return INTERVAL_TIMER_STATUS_FAIL;
 
+    if (SHADOW_REGISTERS) { // the shadows start from a known value here, so both registers are written outright
+        tcsr1Shadow[timerNumber] = CLEAR_REGISTER;
+        tcsr0Shadow[timerNumber] = CLEAR_REGISTER;
+        bool ok = updateControlRegister(baseAddress, TCSR1_OFFSET, &tcsr1Shadow[timerNumber], NO_BITS, NO_BITS); // TCSR1 = 0
+        ok = updateControlRegister(baseAddress, TCSR0_OFFSET, &tcsr0Shadow[timerNumber], CASC_MASK, UDT0_MASK) && ok; // TCSR0 = CASC, counting up and stopped
+        return ok ? INTERVAL_TIMER_STATUS_OK : INTERVAL_TIMER_STATUS_FAIL;
+    }
+
     intervalTimer_writeRegister(baseAddress, TCSR0_OFFSET, CLEAR_REGISTER); // write 0 to the TCSR0 register
     intervalTimer_writeRegister(baseAddress, TCSR1_OFFSET, CLEAR_REGISTER); // write 0 to the TCSR1 register
     intervalTimer_writeRegister(baseAddress, TCSR0_OFFSET, ((intervalTimer_readRegister(baseAddress, TCSR0_OFFSET) | CASC_MASK) & ~UDT0_MASK)); // set the CASC bit and clear the UCT0 bit in the TCSR0 register by reading the value and using a mask to set the 11th bit to 1 and 1st bit to 0
@@ -87,6 +110,14 @@ intervalTimer_status_t intervalTimer_initAll() {
 void intervalTimer_start(uint32_t timerNumber) {
     uint32_t baseAddress = intervalTimer_getBaseAddress(timerNumber); // get the base address based on the timerNumber argument
 
+    if (SHADOW_REGISTERS) { // release the upper counter first, then enable and release the lower one in the same write
+        if (baseAddress == 0) // no shadow for an invalid timer number
+            return;
+        updateControlRegister(baseAddress, TCSR1_OFFSET, &tcsr1Shadow[timerNumber], NO_BITS, LOAD_MASK);
+        updateControlRegister(baseAddress, TCSR0_OFFSET, &tcsr0Shadow[timerNumber], ENT0_MASK, LOAD_MASK);
+        return;
+    }
+
     intervalTimer_writeRegister(baseAddress, TCSR0_OFFSET, (intervalTimer_readRegister(baseAddress, TCSR0_OFFSET) | ENT0_MASK)); // sets the ENT0 bit in the TCSR0 register by reading the value and using a mask to set the 7th bit to 1
     intervalTimer_writeRegister(baseAddress, TCSR0_OFFSET, (intervalTimer_readRegister(baseAddress, TCSR0_OFFSET) & ~LOAD_MASK)); // clears the LOAD0 bit in the TCSR0 register by reading the value and using a mask to set the 5th bit to 0
     intervalTimer_writeRegister(baseAddress, TCSR1_OFFSET, (intervalTimer_readRegister(baseAddress, TCSR1_OFFSET) & ~LOAD_MASK)); // clears the LOAD1 bit in the TCSR1 register by reading the value and using a mask to set the 5th bit to 0
@@ -98,6 +129,13 @@ void intervalTimer_start(uint32_t timerNumber) {
 void intervalTimer_stop(uint32_t timerNumber) {
     uint32_t baseAddress = intervalTimer_getBaseAddress(timerNumber); // get the base address based on the timerNumber argument
 
+    if (SHADOW_REGISTERS) {
+        if (baseAddress == 0) // no shadow for an invalid timer number
+            return;
+        updateControlRegister(baseAddress, TCSR0_OFFSET, &tcsr0Shadow[timerNumber], NO_BITS, ENT0_MASK);
+        return;
+    }
+
     intervalTimer_writeRegister(baseAddress, TCSR0_OFFSET, (intervalTimer_readRegister(baseAddress, TCSR0_OFFSET) & ~ENT0_MASK)); // clears the ENT0 bit in the TCSR0 register by reading the value and using a mask to set the 7th bit to 0
 }
 
@@ -108,6 +146,15 @@ void intervalTimer_stop(uint32_t timerNumber) {
 void intervalTimer_reset(uint32_t timerNumber) {
     uint32_t baseAddress = intervalTimer_getBaseAddress(timerNumber); // get the base address based on the timerNumber argument
 
+    if (SHADOW_REGISTERS) {
+        if (baseAddress == 0) // no shadow for an invalid timer number
+            return;
+        intervalTimer_writeRegister(baseAddress, TLR0_OFFSET, CLEAR_REGISTER);
+        intervalTimer_writeRegister(baseAddress, TRL1_OFFSET, CLEAR_REGISTER);
+        updateControlRegister(baseAddress, TCSR0_OFFSET, &tcsr0Shadow[timerNumber], LOAD_MASK, NO_BITS);
+        updateControlRegister(baseAddress, TCSR1_OFFSET, &tcsr1Shadow[timerNumber], LOAD_MASK, NO_BITS);
+        return;
+    }
     intervalTimer_writeRegister(baseAddress, TLR0_OFFSET, CLEAR_REGISTER); // writes 0 to the TLR0 register
     intervalTimer_writeRegister(baseAddress, TCSR0_OFFSET, (intervalTimer_readRegister(baseAddress, TCSR0_OFFSET) | LOAD_MASK)); // sets the LOAD0 bit in the TCSR0 register by reading the value and using a mask to set the 5th bit to 1
     intervalTimer_writeRegister(baseAddress, TRL1_OFFSET, CLEAR_REGISTER); // writes 1 to the TLR1 register
@@ -142,11 +189,10 @@ intervalTimer_status_t intervalTimer_testAll() {
 // Note that it should not be an error to call this function on a running timer
 // though it usually makes more sense to call this after intervalTimer_stop()
 // has been called. The timerNumber argument determines which timer is read.
+// Code that times things often should use timestamp_read instead, which
+// returns integer ticks and skips the double divide.
 double intervalTimer_getTotalDurationInSeconds(uint32_t timerNumber) {
-    uint32_t baseAddress = intervalTimer_getBaseAddress(timerNumber); // get the base address based on the timerNumber argument
-
-    uint64_t timerAllBits = intervalTimer_readRegister(baseAddress, TCR1_OFFSET); // store the value of the upper 32 bits in timerAllBits
-    timerAllBits = ((timerAllBits << TIMER_WIDTH) | intervalTimer_readRegister(baseAddress, TCR0_OFFSET)); // shift the upper 32 bits into the proper position and read the lower 32 bits
+    uint64_t timerAllBits = timestamp_read(intervalTimer_getBaseAddress(timerNumber)); // read both halves of the 64 bit counter without tearing across a carry
     double timerDuration =  (double) timerAllBits / XPAR_AXI_TIMER_0_CLOCK_FREQ_HZ; // divide the value of the 64 bit counter by the frequency to get seconds
     return timerDuration;
 }
\ No newline at end of file
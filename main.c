@@ -10,6 +10,16 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 */
 
 #include "display.h"
+#include "displayQueue.h"
+#include "inputEvents.h"
+#include "interrupts.h"
+#include "scheduler.h"
+#include "switches.h"
+#include "tickMonitor.h"
+#include "touchInput.h"
+#include "clockControl.h"
+#include "ticTacToeControl.h"
+#include "xparameters.h"
 
 #define X_START 0
 #define Y_START 0
@@ -21,6 +31,15 @@ For questions, contact Brad Hutchings or Jeff Goeders, https://ece.byu.edu/
 #define TRIANGLE_HEIGHT 56
 #define TRINAGLE_WIDTH 50
 
+// set to true to run the clock or tic-tac-toe state machine under the scheduler after the demo
+#define RUN_STATE_MACHINES false
+#define TIC_TAC_TOE_SWITCH_MASK SWITCHES_SW1_MASK // switch 1 up at startup runs tic-tac-toe, down runs the clock
+#define PRIVATE_TIMER_CLOCK_FREQ_HZ (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2) // the ARM private timer runs at half the CPU clock
+#define PRIVATE_TIMER_LOAD_VALUE ((uint32_t) (PRIVATE_TIMER_CLOCK_FREQ_HZ / 1000 * SCHEDULER_TICK_MS - 1))
+#define CLOCK_PERIOD_MS 10
+#define TIC_TAC_TOE_PERIOD_MS 50
+#define TOUCH_PERIOD_MS 10 // sample the touch controller faster than the game ticks
+
 #include <stdio.h>
 int main() {
   display_init(); // Must init all of the software and underlying hardware for
@@ -33,9 +52,39 @@ int main() {
   display_drawTriangle((X_MIDDLE - (TRINAGLE_WIDTH / 2)), (DISPLAY_HEIGHT - TRIANGLE_FROM_EDGE), (X_MIDDLE + (TRINAGLE_WIDTH / 2)), (DISPLAY_HEIGHT - TRIANGLE_FROM_EDGE), X_MIDDLE, (DISPLAY_HEIGHT - (TRIANGLE_FROM_EDGE + TRIANGLE_HEIGHT)), DISPLAY_YELLOW);     //Draw the open triangle
   display_fillTriangle((X_MIDDLE - (TRINAGLE_WIDTH / 2)), TRIANGLE_FROM_EDGE, (X_MIDDLE + (TRINAGLE_WIDTH / 2)), TRIANGLE_FROM_EDGE, X_MIDDLE, (TRIANGLE_FROM_EDGE + TRIANGLE_HEIGHT), DISPLAY_YELLOW);     //Draw the filled triangle
 
+  if (RUN_STATE_MACHINES) {
+    display_fillScreen(DISPLAY_BLACK); // the machine's screen starts from black
+    switches_init();
+    scheduler_init();
+    if (switches_read() & TIC_TAC_TOE_SWITCH_MASK) { // only one machine, they share the LCD and the touch panel
+      ticTacToeControl_init();
+      scheduler_addTask("ticTacToeControl", ticTacToeControl_tick, TIC_TAC_TOE_PERIOD_MS, SCHEDULER_RATE_MONOTONIC);
+    }
+    else {
+      clockControl_init();
+      scheduler_addTask("clockControl", clockControl_tick, CLOCK_PERIOD_MS, SCHEDULER_RATE_MONOTONIC);
+    }
+    scheduler_addTask("touchInput", touchInput_update, TOUCH_PERIOD_MS, SCHEDULER_RATE_MONOTONIC);
+
+    interrupts_initAll(true); // the ARM private timer calls isr_function every SCHEDULER_TICK_MS
+    interrupts_setPrivateTimerLoadValue(PRIVATE_TIMER_LOAD_VALUE);
+    interrupts_enableTimerGlobalInts();
+    interrupts_startArmPrivateTimer();
+    interrupts_enableArmInts();
+    while (1) { // the timer interrupt releases the tasks, this loop runs them
+      scheduler_runReady();
+      if (displayQueue_pending()) // draw a bounded slice of what the tasks queued, here and never in the ISR
+        displayQueue_drain(DISPLAYQUEUE_IDLE_BUDGET);
+      else
+        inputEvents_idle(scheduler_hasReady); // sleep until the next interrupt instead of spinning
+    }
+  }
+
   return 0;
 }
 
 void isr_function() {
-  // Empty for now.
+  tickMonitor_interruptEntry(); // timestamp the release before anything else runs
+  scheduler_release(); // release every task whose period has come around
+  inputEvents_poll(); // pick up any button or switch edge the GPIOs latched since the last tick
 }
\ No newline at end of file
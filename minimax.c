@@ -1,4 +1,6 @@
 #include "minimax.h"
+#include "minimaxScores.h"
+#include "profiler.h"
 
 #include<stdio.h>
 
@@ -7,10 +9,19 @@
 #define BOT 2
 #define LFT 0
 #define RGT 2
-#define MEANINGLESS_SCORE -100
+#define NUM_OF_SQUARES 9
+#define NUM_OF_LINES 8
+#define NO_SQUARES 0x000
 
 static minimax_move_t nextMove;
 
+// Bit masks of the 8 winning lines. Square (row, column) is bit row * 3 + column.
+static const uint16_t winningLines[NUM_OF_LINES] = {
+    0x007, 0x038, 0x1C0, // rows
+    0x049, 0x092, 0x124, // columns
+    0x111, 0x054         // diagonals
+};
+
 // helper function to check for vertical win
 bool verticalWin(minimax_board_t *board) {
     for (int8_t i = 0; i < MINIMAX_BOARD_COLUMNS; i++) { // for loop to move through each column
@@ -63,87 +74,179 @@ bool tieGame(minimax_board_t *board) {
     return true;
 }
 
-// Recursive Minimax Function
-// !!! add more comment here
-minimax_score_t minimax(minimax_board_t *board, bool current_player_is_x) {
-    minimax_score_t scoreTable[MINIMAX_BOARD_ROWS][MINIMAX_BOARD_COLUMNS]; // local variable for the score table, will be filled in the loop for the current level of recursion
-    int8_t score = minimax_computeBoardScore(board, current_player_is_x); // initially set score equal to the current score to see if the game is over
-    
-    if (minimax_isGameOver(score)) {  // if thet game is over, return the score
-        return score;
+// helper function that packs every square holding the given value into a 9 bit mask
+static uint16_t squaresToMask(minimax_board_t *board, uint8_t value) {
+    uint16_t mask = NO_SQUARES;
+    for (int8_t i = 0; i < MINIMAX_BOARD_ROWS; i++) { // for loop to move through each row
+        for (int8_t j = 0; j < MINIMAX_BOARD_COLUMNS; j++) { // for loop to move through each column
+            if (board->squares[i][j] == value)
+                mask |= 1 << (i * MINIMAX_BOARD_COLUMNS + j);
+        }
     }
+    return mask;
+}
+
+// helper function that returns the empty squares completing a line for "mine":
+// lines holding two of mine and none of theirs.
+static uint16_t threatSquares(uint16_t mine, uint16_t theirs) {
+    uint16_t threats = NO_SQUARES;
+    for (int8_t i = 0; i < NUM_OF_LINES; i++) { // for loop to move through each line
+        uint16_t owned = winningLines[i] & mine;
+        if (!(winningLines[i] & theirs) && (owned & (owned - 1))) // two or more of mine and none of theirs
+            threats |= winningLines[i] & ~mine;
+    }
+    return threats;
+}
+
+// helper function that converts the lowest set bit of a square mask into a move
+static void maskToMove(uint16_t mask, minimax_move_t *move) {
+    for (int8_t i = 0; i < NUM_OF_SQUARES; i++) { // lowest bit first, same order the search scans
+        if (mask & (1 << i)) {
+            move->row = i / MINIMAX_BOARD_COLUMNS;
+            move->column = i % MINIMAX_BOARD_COLUMNS;
+            return;
+        }
+    }
+}
+
+// Tactical layer run before the full search. Handles the positions where the
+// answer is forced: an immediate win, a block of the opponent's only threat,
+// and a fork (a move that creates two threats at once, which wins). Returns
+// true and fills in move if it found one, false if the search is still needed.
+static bool tacticalMove(minimax_board_t *board, bool current_player_is_x, minimax_move_t *move) {
+    uint16_t mine = squaresToMask(board, current_player_is_x ? MINIMAX_X_SQUARE : MINIMAX_O_SQUARE);
+    uint16_t theirs = squaresToMask(board, current_player_is_x ? MINIMAX_O_SQUARE : MINIMAX_X_SQUARE);
+    uint16_t empty = ~(mine | theirs) & ((1 << NUM_OF_SQUARES) - 1);
+
+    uint16_t wins = threatSquares(mine, theirs);
+    if (wins) { // take the win
+        maskToMove(wins, move);
+        return true;
+    }
+    uint16_t blocks = threatSquares(theirs, mine);
+    if (blocks) { // any other move loses right away, so block (if there are two, the game is lost anyway)
+        maskToMove(blocks, move);
+        return true;
+    }
+    for (int8_t i = 0; i < NUM_OF_SQUARES; i++) { // look for a square that creates two threats at once
+        uint16_t square = 1 << i;
+        if (!(empty & square))
+            continue;
+        uint16_t forks = threatSquares(mine | square, theirs);
+        if (forks & (forks - 1)) { // two threats, the opponent can only block one of them
+            maskToMove(square, move);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Search kernels specialized on the side to move. Each kernel knows at compile
+// time which square value it places, which score it starts from and whether it
+// maximizes or minimizes, so no node re-tests the current player. The recursion
+// alternates between the two kernels. Both fold the child scan and the move
+// selection into one loop: the first win returns right away, otherwise the last
+// draw is kept, otherwise the last loss (same choices the old scoreTable scan made).
+// If scoreTable is not NULL the kernel records the exact score of every legal
+// move in it (MINIMAX_SCORES_ILLEGAL_MOVE for taken squares) and does not stop
+// at the first win. Only the root is ever given a table.
+static minimax_score_t minimax_searchO(minimax_board_t *board, minimax_move_t *bestMove, minimax_score_t scoreTable[][MINIMAX_BOARD_COLUMNS]);
+
+// X to move: O played last, so only an O win or a draw can end the game here.
+static minimax_score_t minimax_searchX(minimax_board_t *board, minimax_move_t *bestMove, minimax_score_t scoreTable[][MINIMAX_BOARD_COLUMNS]) {
+    minimax_score_t score = minimax_computeBoardScore(board, true); // X to move means O played last
+    if (minimax_isGameOver(score)) // if the game is over, return the score
+        return score;
+
+    minimax_score_t bestScore = MINIMAX_O_WINNING_SCORE; // X maximizes, start from the worst case
     for (int8_t i = 0; i < MINIMAX_BOARD_ROWS; i++) { // for loop to move through each row
         for (int8_t j = 0; j < MINIMAX_BOARD_COLUMNS; j++) { // for loop to move through each column
-            if (board->squares[i][j] == MINIMAX_EMPTY_SQUARE) { // if the square is empty, assign it with the value of the current player
-                if (current_player_is_x) // if the current player is X put an X in the empty square
-                    board->squares[i][j] = MINIMAX_X_SQUARE;
-                else // if the current player is O put an O in the empty square
-                    board->squares[i][j] = MINIMAX_O_SQUARE;
-                scoreTable[i][j] = minimax(board, !current_player_is_x);
-                // !!! add move to move-score table
-                board->squares[i][j] = MINIMAX_EMPTY_SQUARE; // undo the change to the board
+            if (board->squares[i][j] != MINIMAX_EMPTY_SQUARE) { // skip squares that are already taken
+                if (scoreTable)
+                    scoreTable[i][j] = MINIMAX_SCORES_ILLEGAL_MOVE;
+                continue;
             }
-            else { // if there is already a value in the square, assign the corresponding score in the score table to be meaningless
-                scoreTable[i][j] = MEANINGLESS_SCORE;
+            board->squares[i][j] = MINIMAX_X_SQUARE; // try the move
+            score = minimax_searchO(board, NULL, NULL);
+            board->squares[i][j] = MINIMAX_EMPTY_SQUARE; // undo the change to the board
+            if (scoreTable) // add move to move-score table
+                scoreTable[i][j] = score;
+            if (score >= bestScore) { // keep the last move with the best score seen so far
+                bestScore = score;
+                if (bestMove) {
+                    bestMove->row = i;
+                    bestMove->column = j;
+                }
+                if ((score == MINIMAX_X_WINNING_SCORE) && !scoreTable) // nothing beats a win, stop searching
+                    return score;
             }
         }
     }
-    if (current_player_is_x) { // if the current player is X we look for the highest score
-        score = MINIMAX_O_WINNING_SCORE; // default: if no 10s or 0s are found in score table, return -10
-        for (int8_t i = 0; i < MINIMAX_BOARD_ROWS; i++) { // for loop to move through each row
-            for (int8_t j = 0; j < MINIMAX_BOARD_COLUMNS; j++) { // for loop to move through each column
-                if (scoreTable[i][j] == MINIMAX_X_WINNING_SCORE) { // if the score is 10, save that location as the next move and return 10
-                    nextMove.row = i;
-                    nextMove.column = j;
+    return bestScore;
+}
 
-                    // debug printf below
-                    // printf("the next move is at: %d, %d\n", i, j);
+// O to move: X played last, so only an X win or a draw can end the game here.
+static minimax_score_t minimax_searchO(minimax_board_t *board, minimax_move_t *bestMove, minimax_score_t scoreTable[][MINIMAX_BOARD_COLUMNS]) {
+    minimax_score_t score = minimax_computeBoardScore(board, false); // O to move means X played last
+    if (minimax_isGameOver(score)) // if the game is over, return the score
+        return score;
 
-                    return score = scoreTable[i][j];
-                }
-                else if (scoreTable[i][j] == MINIMAX_DRAW_SCORE) { // if the score is 0, save that location as the next move
-                    score = scoreTable[i][j];
-                    nextMove.row = i;
-                    nextMove.column = j;
-                }
-                else if ((score == MINIMAX_X_WINNING_SCORE) && (scoreTable[i][j] == MINIMAX_X_WINNING_SCORE)) {
-                    nextMove.row = i;
-                    nextMove.column = j;
+    minimax_score_t bestScore = MINIMAX_X_WINNING_SCORE; // O minimizes, start from the worst case
+    for (int8_t i = 0; i < MINIMAX_BOARD_ROWS; i++) { // for loop to move through each row
+        for (int8_t j = 0; j < MINIMAX_BOARD_COLUMNS; j++) { // for loop to move through each column
+            if (board->squares[i][j] != MINIMAX_EMPTY_SQUARE) { // skip squares that are already taken
+                if (scoreTable)
+                    scoreTable[i][j] = MINIMAX_SCORES_ILLEGAL_MOVE;
+                continue;
+            }
+            board->squares[i][j] = MINIMAX_O_SQUARE; // try the move
+            score = minimax_searchX(board, NULL, NULL);
+            board->squares[i][j] = MINIMAX_EMPTY_SQUARE; // undo the change to the board
+            if (scoreTable) // add move to move-score table
+                scoreTable[i][j] = score;
+            if (score <= bestScore) { // keep the last move with the best score seen so far
+                bestScore = score;
+                if (bestMove) {
+                    bestMove->row = i;
+                    bestMove->column = j;
                 }
-                // debug printf below
-                // printf("the score being returned is: %d\n", score);
-
+                if ((score == MINIMAX_O_WINNING_SCORE) && !scoreTable) // nothing beats a win, stop searching
+                    return score;
             }
         }
-    } 
-    else { // if the current player is O we look for the lowest score 
-        score = MINIMAX_X_WINNING_SCORE; // default: if no -10s or 0s are found in score table, return 10
-        for (int8_t i = 0; i < MINIMAX_BOARD_ROWS; i++) { // for loop to move through each row
-            for (int8_t j = 0; j < MINIMAX_BOARD_COLUMNS; j++) { // for loop to move through each column
-                if (scoreTable[i][j] == MINIMAX_O_WINNING_SCORE) { // if the score is -10, save that location as the next move and return -10
-                    nextMove.row = i;
-                    nextMove.column = j;
+    }
+    return bestScore;
+}
 
-                    // debug printf below
-                    //printf("the next move is at: %d, %d\n", i, j);
+// Recursive Minimax Function
+// Picks the kernel for the side to move once, at the root. Only the root
+// records its choice in nextMove; the kernels below it pass NULL.
+minimax_score_t minimax(minimax_board_t *board, bool current_player_is_x) {
+    if (current_player_is_x)
+        return minimax_searchX(board, &nextMove, NULL);
+    else
+        return minimax_searchO(board, &nextMove, NULL);
+}
 
-                    return score = scoreTable[i][j];
-                }
-                else if (scoreTable[i][j] == MINIMAX_DRAW_SCORE) { // if the score is 0, save that location as the next move
-                    score = scoreTable[i][j];
-                    nextMove.row = i;
-                    nextMove.column = j;
-                }
-                else if ((score == MINIMAX_X_WINNING_SCORE) && (scoreTable[i][j] == MINIMAX_X_WINNING_SCORE)) { // if a -10 or 0 hasn't been found, save the loaction of the 10 as the next move
-                    nextMove.row = i;
-                    nextMove.column = j;
-                }
-                // debug printf below
-                // printf("the score being returned is: %d\n", score);
+// Fills scores with the exact minimax score of every move for the side to move,
+// MINIMAX_SCORES_ILLEGAL_MOVE where the square is taken. This is one search:
+// the root evaluates each child once, the same work minimax() does, it just
+// keeps the child scores instead of only the best one. Returns the best score.
+minimax_score_t minimax_computeMoveScores(minimax_board_t *board, bool current_player_is_x, minimax_score_t scores[][MINIMAX_BOARD_COLUMNS]) {
+    minimax_move_t bestMove;
+    minimax_score_t score = minimax_computeBoardScore(board, current_player_is_x);
+    if (minimax_isGameOver(score)) { // nothing is legal once the game is over
+        for (int8_t i = 0; i < MINIMAX_BOARD_ROWS; i++) { // for loop to move through each row
+            for (int8_t j = 0; j < MINIMAX_BOARD_COLUMNS; j++) { // for loop to move through each column
+                scores[i][j] = MINIMAX_SCORES_ILLEGAL_MOVE;
             }
         }
+        return score;
     }
-    return score;
+    if (current_player_is_x)
+        return minimax_searchX(board, &bestMove, scores);
+    else
+        return minimax_searchO(board, &bestMove, scores);
 }
 
 // This routine is not recursive but will invoke the recursive minimax function.
@@ -160,10 +263,27 @@ minimax_score_t minimax(minimax_board_t *board, bool current_player_is_x) {
 // values to the row and column arguments, you must use the following syntax in
 // the body of the function: *row = move_row; *column = move_column; (for
 // example).
+// Forced moves are answered by the tactical layer without searching.
 void minimax_computeNextMove(minimax_board_t *board, bool current_player_is_x, uint8_t *row, uint8_t *column) {
-    minimax(board, current_player_is_x);
+    profiler_enter("minimax");
+    if (!tacticalMove(board, current_player_is_x, &nextMove)) // fall back to the full search if nothing is forced
+        minimax(board, current_player_is_x);
     *row = nextMove.row;
     *column = nextMove.column;
+    profiler_exit();
+}
+
+// Like minimax_computeNextMove, but also fills replies with the score of
+// every reply the opponent has to the chosen move. The move comes from the
+// usual tactical layer and cutoff search; only the chosen child is then
+// scored square by square.
+void minimax_computeNextMoveAndReplies(minimax_board_t *board, bool current_player_is_x, uint8_t *row, uint8_t *column, minimax_score_t replies[][MINIMAX_BOARD_COLUMNS]) {
+    minimax_computeNextMove(board, current_player_is_x, row, column);
+    profiler_enter("minimaxReplies");
+    board->squares[*row][*column] = current_player_is_x ? MINIMAX_X_SQUARE : MINIMAX_O_SQUARE; // play the chosen move
+    minimax_computeMoveScores(board, !current_player_is_x, replies);
+    board->squares[*row][*column] = MINIMAX_EMPTY_SQUARE; // undo the change to the board
+    profiler_exit();
 }
 
 // Determine that the game is over by looking at the score.
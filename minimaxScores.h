@@ -0,0 +1,23 @@
+#ifndef MINIMAXSCORES_H_
+#define MINIMAXSCORES_H_
+
+#include "minimax.h"
+
+#include <stdbool.h>
+
+// Score reported for squares that are already taken.
+#define MINIMAX_SCORES_ILLEGAL_MOVE -100
+
+// Fills scores with the exact minimax score of every legal move for the side to
+// move in one search pass. Taken squares get MINIMAX_SCORES_ILLEGAL_MOVE.
+// Returns the score of the best move (or the final score if the game is over).
+minimax_score_t minimax_computeMoveScores(minimax_board_t *board, bool current_player_is_x, minimax_score_t scores[][MINIMAX_BOARD_COLUMNS]);
+
+// Like minimax_computeNextMove, but also fills replies with the exact score of
+// every reply the opponent has to the chosen move (MINIMAX_SCORES_ILLEGAL_MOVE
+// where the square is taken, everywhere if the move ends the game). The move
+// is picked exactly as minimax_computeNextMove picks it; the replies cost one
+// extra search of the position after the move, one ply smaller.
+void minimax_computeNextMoveAndReplies(minimax_board_t *board, bool current_player_is_x, uint8_t *row, uint8_t *column, minimax_score_t replies[][MINIMAX_BOARD_COLUMNS]);
+
+#endif /* MINIMAXSCORES_H_ */
@@ -0,0 +1,133 @@
+#include "profiler.h"
+#include "intervalTimer.h"
+#include "timestamp.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define HISTOGRAM_TOP_BIT 31
+#define NO_NODE 0xFF
+#define ROOT_NODE 0 // the implicit outermost scope, never timed
+#define REPORT_INDENT 2
+
+// one node of the call tree
+typedef struct {
+    const char *name;
+    uint8_t parent, firstChild, nextSibling;
+    uint32_t count;
+    uint64_t total;
+    uint64_t children; // time spent in child scopes, for the self time
+    uint32_t min, max;
+    uint32_t histogram[PROFILER_HISTOGRAM_BUCKETS];
+} node_t;
+
+static node_t nodes[PROFILER_MAX_SCOPES];
+static uint8_t nodeCount;
+static uint8_t stack[PROFILER_MAX_DEPTH]; // open nodes, innermost last
+static uint64_t startTicks[PROFILER_MAX_DEPTH];
+static uint8_t depth;
+static uint32_t dropped; // enters that found the tree or the stack full
+static timestamp_handle_t timer;
+
+// helper function that returns the child of parent called name, adding it if it is new
+static uint8_t findChild(uint8_t parent, const char *name) {
+    uint8_t child;
+    for (child = nodes[parent].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+        if (nodes[child].name == name)
+            return child;
+    if (nodeCount == PROFILER_MAX_SCOPES)
+        return NO_NODE;
+    child = nodeCount++;
+    nodes[child].name = name;
+    nodes[child].parent = parent;
+    nodes[child].firstChild = NO_NODE;
+    nodes[child].nextSibling = nodes[parent].firstChild;
+    nodes[child].min = UINT32_MAX;
+    nodes[parent].firstChild = child;
+    return child;
+}
+
+// Starts the profiler's timer and clears all results. Calling it again
+// restarts the profile.
+void profiler_init() {
+    if (!PROFILER_ENABLED)
+        return;
+    memset(nodes, 0, sizeof(nodes));
+    nodes[ROOT_NODE].name = "total";
+    nodes[ROOT_NODE].parent = NO_NODE;
+    nodes[ROOT_NODE].firstChild = NO_NODE;
+    nodes[ROOT_NODE].nextSibling = NO_NODE;
+    nodeCount = 1;
+    depth = 0;
+    dropped = 0;
+    intervalTimer_init(PROFILER_TIMER);
+    intervalTimer_reset(PROFILER_TIMER);
+    intervalTimer_start(PROFILER_TIMER);
+    timer = timestamp_getHandle(PROFILER_TIMER);
+}
+
+// Opens a scope nested in the scope that is open now. name is compared by
+// pointer, so pass a string literal.
+void profiler_enter(const char *name) {
+    if (!PROFILER_ENABLED)
+        return;
+    uint8_t parent = (depth == 0) ? ROOT_NODE : stack[depth - 1];
+    uint8_t node = (depth < PROFILER_MAX_DEPTH && parent != NO_NODE) ? findChild(parent, name) : NO_NODE;
+    if (node == NO_NODE)
+        dropped++;
+    if (depth < PROFILER_MAX_DEPTH) { // a dropped scope still takes a stack slot so the exits stay paired
+        stack[depth] = node;
+        startTicks[depth] = timestamp_read(timer); // last, so the bookkeeping above isn't timed
+    }
+    depth++;
+}
+
+// Closes the innermost open scope and records its time.
+void profiler_exit() {
+    if (!PROFILER_ENABLED)
+        return;
+    uint64_t now = timestamp_read(timer); // first, so the bookkeeping below isn't timed
+    if (depth == 0) // unpaired exit
+        return;
+    depth--;
+    if (depth >= PROFILER_MAX_DEPTH || stack[depth] == NO_NODE)
+        return;
+    node_t *node = &nodes[stack[depth]];
+    uint64_t elapsed = now - startTicks[depth];
+    uint32_t ticks = (elapsed > UINT32_MAX) ? UINT32_MAX : (uint32_t) elapsed;
+    node->count++;
+    node->total += elapsed;
+    if (ticks < node->min)
+        node->min = ticks;
+    if (ticks > node->max)
+        node->max = ticks;
+    node->histogram[HISTOGRAM_TOP_BIT - __builtin_clz(ticks | 1)]++;
+    nodes[node->parent].children += elapsed;
+}
+
+// helper function that prints one node and everything under it
+static void printNode(uint8_t index, uint8_t indent) {
+    node_t *node = &nodes[index];
+    printf("%*s%-20s %8lu calls %10llu us total %10llu us self %8lu/%lu us min/max\n", indent, "", node->name, (unsigned long) node->count,
+           (unsigned long long) timestamp_toMicroseconds(node->total), (unsigned long long) timestamp_toMicroseconds(node->total - node->children),
+           (unsigned long) timestamp_toMicroseconds(node->min), (unsigned long) timestamp_toMicroseconds(node->max));
+    printf("%*s  ticks histogram:", indent, "");
+    for (uint8_t b = 0; b < PROFILER_HISTOGRAM_BUCKETS; b++)
+        if (node->histogram[b])
+            printf(" 2^%u:%lu", b, (unsigned long) node->histogram[b]);
+    printf("\n");
+    for (uint8_t child = node->firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+        printNode(child, indent + REPORT_INDENT);
+}
+
+// Prints the call tree over the UART with counts, total/self time,
+// min/max per call and the non-empty histogram buckets.
+void profiler_printReport() {
+    if (!PROFILER_ENABLED)
+        return;
+    for (uint8_t child = nodes[ROOT_NODE].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+        printNode(child, 0);
+    if (dropped)
+        printf("%lu scopes dropped, raise PROFILER_MAX_SCOPES or PROFILER_MAX_DEPTH\n", (unsigned long) dropped);
+}
@@ -0,0 +1,38 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+
+// Hierarchical profiler on one of the AXI interval timers. Code is timed by
+// wrapping it in profiler_enter("name") / profiler_exit() pairs, which may
+// nest. Each distinct path of names gets its own node in a call tree, with
+// the call count, total, min and max time in raw timer ticks and a log2
+// histogram of the per-call times. Everything lives in static storage and
+// each enter or exit costs three timer register reads.
+//
+// A scope that is interrupted includes the time spent in the interrupt.
+
+// set to 1 to turn the instrumentation on; at 0 every call returns right away
+#define PROFILER_ENABLED 0
+
+#define PROFILER_TIMER INTERVAL_TIMER_TIMER_2 // left free-running while profiling
+#define PROFILER_MAX_SCOPES 32 // nodes in the call tree
+#define PROFILER_MAX_DEPTH 8
+#define PROFILER_HISTOGRAM_BUCKETS 32 // bucket b counts calls that took 2^b to 2^(b+1)-1 ticks
+
+// Starts the profiler's timer and clears all results. Calling it again
+// restarts the profile.
+void profiler_init();
+
+// Opens a scope nested in the scope that is open now. name is compared by
+// pointer, so pass a string literal.
+void profiler_enter(const char *name);
+
+// Closes the innermost open scope and records its time.
+void profiler_exit();
+
+// Prints the call tree over the UART with counts, total/self time,
+// min/max per call and the non-empty histogram buckets.
+void profiler_printReport();
+
+#endif /* PROFILER_H_ */
@@ -0,0 +1,139 @@
+#include "scheduler.h"
+#include "intervalTimer.h"
+#include "timestamp.h"
+
+#include <stdio.h>
+
+#define PERMILLE 1000
+#define US_PER_MS 1000
+
+typedef struct {
+    const char *name;
+    scheduler_tick_t tick;
+    uint16_t periodTicks; // in timer interrupts
+    uint8_t priority;
+    volatile uint16_t countdown; // interrupts until the next release
+    volatile uint32_t released; // counted by the interrupt
+    uint64_t releaseTicks; // when the pending release came; the interrupt leaves it alone until it has run
+    uint32_t completed; // counted by the main loop, pending while it trails released
+    volatile uint32_t overruns;
+    uint32_t runs;
+    uint64_t busyTicks;
+    uint32_t worstTicks;
+} task_t;
+
+static task_t tasks[SCHEDULER_MAX_TASKS]; // kept sorted by priority, highest first
+static uint8_t taskCount;
+static task_t *runningTask; // the task whose tick is running, NULL between ticks
+static timestamp_handle_t timer;
+static uint64_t startTicks;
+
+// rate-monotonic utilization bound n(2^(1/n) - 1) in permille, by number of tasks
+static const uint16_t rateMonotonicBound[SCHEDULER_MAX_TASKS] = {1000, 828, 779, 756, 743, 734, 728, 724};
+
+// Clears the task table and starts the time base.
+void scheduler_init() {
+    taskCount = 0;
+    timer = timestamp_startTimer(SCHEDULER_TIMER);
+    startTicks = timestamp_read(timer);
+}
+
+// Adds a task that runs tick every periodMs (a multiple of SCHEDULER_TICK_MS).
+// A lower priority number runs first; SCHEDULER_RATE_MONOTONIC ranks the task
+// by period, shorter first. Returns false if the table is full or the
+// period isn't a multiple of the interrupt period.
+bool scheduler_addTask(const char *name, scheduler_tick_t tick, uint16_t periodMs, uint8_t priority) {
+    if ((taskCount == SCHEDULER_MAX_TASKS) || (periodMs == 0) || (periodMs % SCHEDULER_TICK_MS))
+        return false;
+    if (priority == SCHEDULER_RATE_MONOTONIC) // shorter period, higher priority; stays below every explicit priority
+        priority = (periodMs / SCHEDULER_TICK_MS < SCHEDULER_RATE_MONOTONIC) ? periodMs / SCHEDULER_TICK_MS : SCHEDULER_RATE_MONOTONIC - 1;
+    uint8_t i = taskCount++;
+    while ((i > 0) && (tasks[i - 1].priority > priority)) { // insertion sort, equal priorities keep their order
+        tasks[i] = tasks[i - 1];
+        i--;
+    }
+    tasks[i] = (task_t) {name, tick, periodMs / SCHEDULER_TICK_MS, priority, periodMs / SCHEDULER_TICK_MS, 0, 0, 0, 0, 0, 0, 0};
+    return true;
+}
+
+// Releases the tasks that are due. Call from the timer interrupt.
+void scheduler_release() {
+    uint64_t now = timestamp_read(timer);
+    for (uint8_t i = 0; i < taskCount; i++) {
+        task_t *task = &tasks[i];
+        if (--task->countdown)
+            continue;
+        task->countdown = task->periodTicks;
+        if (task->released != task->completed) // the last release is still waiting or running
+            task->overruns++;
+        else {
+            task->releaseTicks = now;
+            __sync_synchronize(); // the time is written before the main loop can see the release
+            task->released++;
+        }
+    }
+}
+
+// Runs every released task, highest priority first, and returns when none
+// are left. Call from the main loop.
+void scheduler_runReady() {
+    uint8_t i = 0;
+    while (i < taskCount) {
+        task_t *task = &tasks[i];
+        if (task->released == task->completed) {
+            i++;
+            continue;
+        }
+        uint64_t start = timestamp_read(timer);
+        runningTask = task;
+        task->tick();
+        runningTask = NULL;
+        uint32_t elapsed = timestamp_read(timer) - start;
+        task->busyTicks += elapsed;
+        if (elapsed > task->worstTicks)
+            task->worstTicks = elapsed;
+        task->runs++;
+        task->completed = task->released;
+        i = 0; // something more important may have been released meanwhile
+    }
+}
+
+// Sets ticks to the time the running task was released. Returns false when
+// no task is running.
+bool scheduler_getReleaseTicks(uint64_t *ticks) {
+    if (!runningTask)
+        return false;
+    *ticks = runningTask->releaseTicks; // stable: the interrupt doesn't touch it until the task has run
+    return true;
+}
+
+// Returns true if any task has been released and not run yet.
+bool scheduler_hasReady() {
+    for (uint8_t i = 0; i < taskCount; i++) {
+        if (tasks[i].released != tasks[i].completed)
+            return true;
+    }
+    return false;
+}
+
+// Prints releases, runs, overruns, worst-case run time and CPU utilization
+// per task, and checks the total against the rate-monotonic bound. Prints
+// nothing when no task has been added.
+void scheduler_printStats() {
+    if (!taskCount)
+        return;
+    uint64_t elapsed = timestamp_read(timer) - startTicks;
+    uint32_t totalUtilization = 0; // measured, permille
+    uint32_t worstCaseUtilization = 0; // every run at its worst case, permille
+    for (uint8_t i = 0; i < taskCount; i++) {
+        task_t *task = &tasks[i];
+        uint32_t utilization = elapsed ? (uint32_t) (task->busyTicks * PERMILLE / elapsed) : 0;
+        uint32_t worstUs = timestamp_toMicroseconds(task->worstTicks);
+        totalUtilization += utilization;
+        worstCaseUtilization += worstUs * PERMILLE / (task->periodTicks * SCHEDULER_TICK_MS * US_PER_MS);
+        printf("%-18s prio %3u %5u ms: %8lu runs %6lu overruns, worst %6lu us, cpu %3lu.%lu%%\n", task->name, task->priority, task->periodTicks * SCHEDULER_TICK_MS,
+               (unsigned long) task->runs, (unsigned long) task->overruns, (unsigned long) worstUs, (unsigned long) utilization / 10, (unsigned long) utilization % 10);
+    }
+    printf("cpu %lu.%lu%%, worst case %lu.%lu%% against the rate-monotonic bound of %u.%u%%\n", (unsigned long) totalUtilization / 10, (unsigned long) totalUtilization % 10,
+           (unsigned long) worstCaseUtilization / 10, (unsigned long) worstCaseUtilization % 10, rateMonotonicBound[taskCount - 1] / 10, rateMonotonicBound[taskCount - 1] % 10);
+}
@@ -0,0 +1,57 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Cooperative rate-monotonic scheduler for the tick functions. Each task has
+// a period and a priority; the timer interrupt calls scheduler_release(),
+// which releases every task whose period has come around, and the main loop
+// calls scheduler_runReady(), which runs the released tasks one at a time,
+// highest priority first. Tasks are never preempted, so a tick function must
+// return before the others can run.
+//
+// A release that comes while the task's previous release hasn't finished is
+// a deadline overrun: it is counted and the late release is merged into the
+// pending one. Run times are measured on the shared free-running timer to
+// give each task's worst case and CPU utilization.
+
+#define SCHEDULER_MAX_TASKS 8
+#define SCHEDULER_TICK_MS 10 // period of the timer interrupt that calls scheduler_release
+#define SCHEDULER_TIMER INTERVAL_TIMER_TIMER_1 // only read, shared with the timer wheel
+
+// Pass as the priority to rank a task by its period alone (rate-monotonic).
+#define SCHEDULER_RATE_MONOTONIC 0xFF
+
+typedef void (*scheduler_tick_t)();
+
+// Clears the task table and starts the time base.
+void scheduler_init();
+
+// Adds a task that runs tick every periodMs (a multiple of SCHEDULER_TICK_MS).
+// A lower priority number runs first; SCHEDULER_RATE_MONOTONIC ranks the task
+// by period, shorter first. Returns false if the table is full or the
+// period isn't a multiple of the interrupt period.
+bool scheduler_addTask(const char *name, scheduler_tick_t tick, uint16_t periodMs, uint8_t priority);
+
+// Releases the tasks that are due. Call from the timer interrupt.
+void scheduler_release();
+
+// Runs every released task, highest priority first, and returns when none
+// are left. Call from the main loop.
+void scheduler_runReady();
+
+// Sets ticks to the time, on the shared time base, at which the task that
+// is running now was released. Returns false when no task is running, for
+// instance when a tick function is called outside the scheduler.
+bool scheduler_getReleaseTicks(uint64_t *ticks);
+
+// Returns true if any task has been released and not run yet.
+bool scheduler_hasReady();
+
+// Prints releases, runs, overruns, worst-case run time and CPU utilization
+// per task, and checks the total against the rate-monotonic bound. Prints
+// nothing when no task has been added.
+void scheduler_printStats();
+
+#endif /* SCHEDULER_H_ */
@@ -1,4 +1,6 @@
 #include "switches.h"
+#include "inputEvents.h"
+#include "inputSnapshot.h"
 #include "leds.h"
 #include "xil_io.h"
 #include "xparameters.h"
@@ -48,39 +50,44 @@ int32_t switches_read() {
 void switches_runTest() {
   uint8_t ledValue = 0x00;
   switches_init();
+  inputEvents_init(); // with events on, the loop below sleeps until a switch changes
+  inputSnapshot_init();
 
   while (1) { // runs the function until all switches are turned on
-    if ((switches_read() & ALL_ON) ==
+    inputSnapshot_update(); // one debounced read for every test below
+    uint8_t value = INPUTSNAPSHOT_GET_SWITCHES(inputSnapshot_getHeld());
+    if ((value & ALL_ON) ==
         ALL_ON) {          // check if all four switches are on
       leds_write(~ALL_ON); // turn off all four LEDs
       break;               // return from function if all four switches are on
     }
 
-    if ((switches_read() & SWITCHES_SW0_MASK) ==
+    if ((value & SWITCHES_SW0_MASK) ==
         SWITCHES_SW0_MASK) // check if switch 0 is on
       ledValue = (ledValue | SWITCHES_SW0_MASK);
     else
       ledValue = (ledValue & ~SWITCHES_SW0_MASK);
 
-    if ((switches_read() & SWITCHES_SW1_MASK) ==
+    if ((value & SWITCHES_SW1_MASK) ==
         SWITCHES_SW1_MASK) // check if switch 1 is on
       ledValue = (ledValue | SWITCHES_SW1_MASK);
     else
       ledValue = (ledValue & ~SWITCHES_SW1_MASK);
 
-    if ((switches_read() & SWITCHES_SW2_MASK) ==
+    if ((value & SWITCHES_SW2_MASK) ==
         SWITCHES_SW2_MASK) // check if switch 2 is on
       ledValue = (ledValue | SWITCHES_SW2_MASK);
     else
       ledValue = (ledValue & ~SWITCHES_SW2_MASK);
 
-    if ((switches_read() & SWITCHES_SW3_MASK) ==
+    if ((value & SWITCHES_SW3_MASK) ==
         SWITCHES_SW3_MASK) // check if switch 3 is on
       ledValue = (ledValue | SWITCHES_SW3_MASK);
     else
       ledValue = (ledValue & ~SWITCHES_SW3_MASK);
 
     leds_write(ledValue); // turn on or off LEDs according to new ledValue
+    inputSnapshot_wait(); // update only when something could have changed
   }
 
   return;
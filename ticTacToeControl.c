@@ -1,8 +1,23 @@
 #include "ticTacToeControl.h"
 #include "ticTacToeDisplay.h"
 #include "minimax.h"
+#include "minimaxScores.h"
 #include "display.h"
 #include "buttons.h"
+#include "switches.h"
+#include "ticTacToeHint.h"
+#include "ticTacToeGeometry.h"
+#include "displayRetained.h"
+#include "displayBuffer.h"
+#include "displayQueue.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "timerWheel.h"
+#include "tickMonitor.h"
+#include "fsm.h"
+#include "inputEvents.h"
+#include "inputSnapshot.h"
+#include "touchInput.h"
 
 #include <stdio.h>
 
@@ -12,6 +27,7 @@
 #define LFT 0
 #define RGT 2
 #define BTN_0_MASK 0x0001
+#define HINT_SWITCH_MASK 0x0001 // slide switch 0 up turns on the move hints
 #define TEXT_SIZE 2
 #define LINE_1_CUROSR_X 35
 #define LINE_2_CURSOR_X 120
@@ -22,34 +38,40 @@
 #define LINE_3_CURSOR_Y 122
 #define LINE_4_CURSOR_Y 137
 
-#define ADC_COUNTER_MAX_VALUE 1
-#define START_SCREEN_COUNTER_MAX_VALUE 40
-// right now the player start timer will wait for 3s
-#define PLAYER_START_COUNTER_MAX_VALUE 40
-
-//helper function to handle all the display pieces for the start screen
-void displayStartScreen(bool erase) {
-    if (erase)
-        display_setTextColor(DISPLAY_BLACK); // set the text color to black if erasing
-    else
-        display_setTextColor(DISPLAY_WHITE); // set the text color to white if not erasing
-    display_setTextSize(TEXT_SIZE); // set the test size
-    display_setCursor(LINE_1_CUROSR_X, LINE_1_CURSOR_Y); // set the cursor for line 1
-    display_print("Touch board to play X"); // print line 1
-    display_setCursor(LINE_2_CURSOR_X, LINE_2_CURSOR_Y); // set the cursor for line 2
-    display_print("-or-"); // print line 2
-    display_setCursor(LINE_3_CURSOR_X, LINE_3_CURSOR_Y); // set the cursor for line 3
-    display_print("wait for the computer"); // print line 3
-    display_setCursor(LINE_4_CURSOR_X, LINE_4_CURSOR_Y); // set the cursor for line 4
-    display_print("and play O."); // print line 4
-}
+#define START_SCREEN_MS 3000
+#define PLAYER_START_MS 3000 // the computer plays first if the player hasn't touched the board by then
+#define TICK_PERIOD_INTERRUPTS 5 // ticked every 50 ms by the 10 ms timer interrupt
+
+#define START_SCREEN 0
+#define BOARD_SCREEN 1
+#define START_SCREEN_ELEMENTS 4
+#define BOARD_SCREEN_ELEMENTS 4
+// set to true to print how many pixels the retained screens sent on each tick that drew something
+#define REPORT_PIXELS_PER_TICK false
+#define TRACE_TRANSITIONS false // set to true to print every state transition
+
+// the start screen text, declared once and drawn by the retained display layer
+static const displayRetained_element_t startScreen[START_SCREEN_ELEMENTS] = {
+    {DISPLAYRETAINED_TEXT, START_SCREEN, LINE_1_CUROSR_X, LINE_1_CURSOR_Y, 0, 0, "Touch board to play X", TEXT_SIZE, DISPLAY_WHITE},
+    {DISPLAYRETAINED_TEXT, START_SCREEN, LINE_2_CURSOR_X, LINE_2_CURSOR_Y, 0, 0, "-or-", TEXT_SIZE, DISPLAY_WHITE},
+    {DISPLAYRETAINED_TEXT, START_SCREEN, LINE_3_CURSOR_X, LINE_3_CURSOR_Y, 0, 0, "wait for the computer", TEXT_SIZE, DISPLAY_WHITE},
+    {DISPLAYRETAINED_TEXT, START_SCREEN, LINE_4_CURSOR_X, LINE_4_CURSOR_Y, 0, 0, "and play O.", TEXT_SIZE, DISPLAY_WHITE}
+};
+
+// the four board lines as one-pixel solid runs, declared once and drawn by the retained display layer
+static const displayRetained_element_t boardScreen[BOARD_SCREEN_ELEMENTS] = {
+    {DISPLAYRETAINED_FILLED_RECT, BOARD_SCREEN, 0, ONE_THIRD_DISPLAY_HEIGHT, DISPLAY_WIDTH, BOARD_LINE_WIDTH, NULL, 0, DISPLAY_WHITE}, // upper horizontal line
+    {DISPLAYRETAINED_FILLED_RECT, BOARD_SCREEN, 0, TWO_THIRDS_DISPLAY_HEIGHT, DISPLAY_WIDTH, BOARD_LINE_WIDTH, NULL, 0, DISPLAY_WHITE}, // lower horizontal line
+    {DISPLAYRETAINED_FILLED_RECT, BOARD_SCREEN, ONE_THIRD_DISPLAY_WIDTH, 0, BOARD_LINE_WIDTH, DISPLAY_HEIGHT, NULL, 0, DISPLAY_WHITE}, // left vertical line
+    {DISPLAYRETAINED_FILLED_RECT, BOARD_SCREEN, TWO_THIRDS_DISPLAY_WIDTH, 0, BOARD_LINE_WIDTH, DISPLAY_HEIGHT, NULL, 0, DISPLAY_WHITE} // right vertical line
+};
 
 // States of the clockControl state machine
 enum ticTacToeControl_st_t {
     init_st, // Start here, transition out of this state on the first tick.
     start_screen_st, // Display the start screen here, transition out when the counter expires
     blank_board_st,    // display the board and wait for player input or counter expiration
-    adc_counter_running_st,  // waiting for the touch-controller ADC to settle.
+    adc_counter_running_st,  // waiting for the touch input to settle on a point.
     check_valid_move_st, // check that the touched square isn't already filled
     player_move_st, // add the player's move to the board
     computer_move_st, // add the computer's move to the board
@@ -57,156 +79,277 @@ enum ticTacToeControl_st_t {
     game_over_st   // the game ended, wait for button 0 to be pressed to start a new game
 };
 
-static enum ticTacToeControl_st_t currentState;
+static fsm_t fsm;
 
-// Tick the tic-tac-toe conroller state machine
-void ticTacToeControl_tick() {
-    static uint8_t adcCounter = 0;
-    static uint8_t startScreenCounter = 0;
-    static uint8_t playerStartCounter = 0;
-    static minimax_move_t nextMove;
-    static bool board_is_empty = true;
-    static bool current_player_is_x = true;
-
-    static minimax_board_t gameBoard; // initialize this in the blank board state
-
-    // Perform state updates first. Mealy actions go here as well
-    switch (currentState) {
-        case init_st:
-            currentState = start_screen_st;
-            break;
-        case start_screen_st:
-            if (startScreenCounter == START_SCREEN_COUNTER_MAX_VALUE) {
-                currentState = blank_board_st;
-                displayStartScreen(true); // erase the start screen message by rewriting it in black
-            }
-            break;
-        case blank_board_st:
-            if (display_isTouched()) { // if the player touches the LCD screen, move to adc_counter_running_st
-                currentState = adc_counter_running_st;
-                display_clearOldTouchData(); // clear the previous touch data
-            }
-            else if (playerStartCounter == PLAYER_START_COUNTER_MAX_VALUE)
-                currentState = computer_move_st;
-            break;
-        case adc_counter_running_st:
-            if (adcCounter == ADC_COUNTER_MAX_VALUE)
-                currentState = check_valid_move_st;
-            break;
-        case check_valid_move_st:
-            if (gameBoard.squares[nextMove.row][nextMove.column] == MINIMAX_EMPTY_SQUARE) // if the square selected by the player is empty, move to player_move_st
-                currentState = player_move_st;
-            else // if the square selected by the player is filled, move to waiting_for_player_st
-                currentState = waiting_for_player_st;
-            break;
-        case player_move_st:
-            if (minimax_isGameOver(minimax_computeBoardScore(&gameBoard, current_player_is_x))) // if the game is over, move to game_over_st
-                currentState = game_over_st;
-            else { // otherwise move to computer_move_st
-                currentState = computer_move_st;
-                current_player_is_x = !current_player_is_x;
-            }
-            break;
-        case computer_move_st:
-            if (minimax_isGameOver(minimax_computeBoardScore(&gameBoard, current_player_is_x))) // if the game is over, move to game_over_st
-                currentState = game_over_st;
-            else { // otherwise move to waiting_for_player_st
-                currentState = waiting_for_player_st;
-                current_player_is_x = !current_player_is_x;
-            }
-            break;
-        case waiting_for_player_st:
-            if (display_isTouched()) { // if the player touches the LCD screen, move to adc_counter_running_st
-                currentState = adc_counter_running_st;
-                display_clearOldTouchData(); // clear the old touch data
+// state names for the tick monitor and the transition trace, in enum order
+static const char *const stateNames[] = {"init_st", "start_screen_st", "blank_board_st", "adc_counter_running_st", "check_valid_move_st", "player_move_st", "computer_move_st", "waiting_for_player_st", "game_over_st"};
+static uint8_t monitorId = TICKMONITOR_NO_MACHINE;
+
+static timerWheel_timer_t startScreenTimer; // software timers on the shared wheel, polled with timerWheel_isArmed
+static timerWheel_timer_t playerStartTimer;
+static minimax_move_t nextMove;
+static bool board_is_empty = true;
+static bool current_player_is_x = true;
+
+static minimax_board_t gameBoard; // initialize this in the blank board state
+
+static minimax_score_t moveReplies[MINIMAX_BOARD_ROWS][MINIMAX_BOARD_COLUMNS]; // the player's move scores, filled along with the computer's move
+static minimax_score_t openingReplies[MINIMAX_BOARD_ROWS][MINIMAX_BOARD_COLUMNS]; // the same after the opening corner, searched once at init
+static const minimax_score_t (*hintScores)[MINIMAX_BOARD_COLUMNS]; // what the next hint shows, NULL for no hint
+
+// transitions out of the states with more than one, indices into their rows below
+enum {BLANK_TOUCHED, BLANK_EXPIRED};
+enum {ADC_SETTLED, ADC_ABANDONED};
+enum {CHECK_EMPTY, CHECK_TAKEN};
+enum {MOVE_GAME_OVER, MOVE_NEXT_TURN};
+
+// transition selection, one function per state that can stay or branch
+
+// helper function that leaves the start screen once it has been up long enough
+static uint8_t startScreenSelect() {
+    return timerWheel_isArmed(&startScreenTimer) ? FSM_STAY : 0;
+}
+
+// helper function that waits for the player to touch the board, or for their chance to go first to pass
+static uint8_t blankBoardSelect() {
+    if (touchInput_isTouched())
+        return BLANK_TOUCHED;
+    return timerWheel_isArmed(&playerStartTimer) ? FSM_STAY : BLANK_EXPIRED;
+}
+
+// helper function that waits for the touch to settle, or to be let go without a usable reading
+static uint8_t adcCounterRunningSelect() {
+    if (touchInput_isSettled())
+        return ADC_SETTLED;
+    return touchInput_isAbandoned() ? ADC_ABANDONED : FSM_STAY;
+}
+
+// helper function that checks that the square selected by the player is empty
+static uint8_t checkValidMoveSelect() {
+    return (gameBoard.squares[nextMove.row][nextMove.column] == MINIMAX_EMPTY_SQUARE) ? CHECK_EMPTY : CHECK_TAKEN;
+}
+
+// helper function that checks whether the last move ended the game, for both move states
+static uint8_t moveSelect() {
+    return minimax_isGameOver(minimax_computeBoardScore(&gameBoard, current_player_is_x)) ? MOVE_GAME_OVER : MOVE_NEXT_TURN;
+}
+
+// helper function that leaves waiting_for_player_st on a touch
+static uint8_t waitingForPlayerSelect() {
+    return touchInput_isTouched() ? 0 : FSM_STAY;
+}
+
+// helper function that starts a new game once button 0 has been pressed
+static uint8_t gameOverSelect() {
+    return (inputSnapshot_get().pressed & INPUTSNAPSHOT_BUTTONS(BTN_0_MASK)) ? 0 : FSM_STAY;
+}
+
+// helper function that returns true if the player asked for hints with the hint switch
+static bool hintsWanted() {
+    return (inputSnapshot_getHeld() & INPUTSNAPSHOT_SWITCHES(HINT_SWITCH_MASK)) == INPUTSNAPSHOT_SWITCHES(HINT_SWITCH_MASK);
+}
+
+// transition actions
+
+// helper function that puts up the start screen and clears the board
+static void startGame() {
+    timerWheel_start(&startScreenTimer, START_SCREEN_MS, NULL, NULL);
+    minimax_initBoard(&gameBoard); // initialize the game board to all empty squares
+}
+
+// helper function that gives the player a few seconds to go first
+static void startPlayerTimer() {
+    timerWheel_start(&playerStartTimer, PLAYER_START_MS, NULL, NULL);
+}
+
+// helper function that lets the player go first
+static void playerGoesFirst() {
+    timerWheel_cancel(&playerStartTimer);
+}
+
+// helper function that hands the turn to the other player
+static void switchPlayer() {
+    current_player_is_x = !current_player_is_x;
+}
+
+// helper function that hands the turn back to the player, with hints if they asked for them
+static void switchToPlayer() {
+    current_player_is_x = !current_player_is_x;
+    if (hintScores) // the computer's move search already scored every reply
+        ticTacToeHint_draw(hintScores, current_player_is_x);
+}
+
+// helper function that erases every symbol and starts the next game
+static void resetGame() {
+    startPlayerTimer();
+    current_player_is_x = true;
+    for (int8_t i = 0; i < MINIMAX_BOARD_ROWS; i++) { // for loop to move through each row
+        for (int8_t j = 0; j < MINIMAX_BOARD_COLUMNS; j++) { // for loop to move through each column
+            if (gameBoard.squares[i][j] == MINIMAX_X_SQUARE) { // if there is an X here, erase it from the display and remove it from the gameBoard
+                ticTacToeDisplay_drawX(i, j, true); // erase the X in this i,j position on the board
+                gameBoard.squares[i][j] = MINIMAX_EMPTY_SQUARE;
             }
-            break;
-        case game_over_st:
-            if ((buttons_read() & BTN_0_MASK) == BTN_0_MASK) { // if button 0 is pressed reset the game
-                currentState = blank_board_st;
-                current_player_is_x = true;
-                for (int8_t i = 0; i < MINIMAX_BOARD_ROWS; i++) { // for loop to move through each row
-                    for (int8_t j = 0; j < MINIMAX_BOARD_COLUMNS; j++) { // for loop to move through each column
-                        if (gameBoard.squares[i][j] == MINIMAX_X_SQUARE) { // if there is an X here, erase it from the display and remove it from the gameBoard
-                            ticTacToeDisplay_drawX(i, j, true); // erase the X in this i,j position on the board
-                            gameBoard.squares[i][j] = MINIMAX_EMPTY_SQUARE;
-                        }
-                        else if (gameBoard.squares[i][j] == MINIMAX_O_SQUARE) { // if there is an O here, erase it from the display and remove it from the gameBoard
-                            ticTacToeDisplay_drawO(i, j, true); // erase the O in this i,j position on the board
-                            gameBoard.squares[i][j] = MINIMAX_EMPTY_SQUARE;
-                        }
-                    }
-                }
+            else if (gameBoard.squares[i][j] == MINIMAX_O_SQUARE) { // if there is an O here, erase it from the display and remove it from the gameBoard
+                ticTacToeDisplay_drawO(i, j, true); // erase the O in this i,j position on the board
+                gameBoard.squares[i][j] = MINIMAX_EMPTY_SQUARE;
             }
-            break;
-        default:
-            printf("ERROR\n"); // print an error message if the state machine is not in one of the defined states
-            break;
+        }
     }
+}
 
-    // Perform the state actions next
-    switch (currentState) {
-        case init_st:
-            break;
-        case start_screen_st:
-            displayStartScreen(false); // call the helper function to display the start screen
-            minimax_initBoard(&gameBoard); // initialize the game board to all empty squares
-            startScreenCounter++;
-            break;
-        case blank_board_st:
-            ticTacToeDisplay_init(); // show a blank board on the display
-            playerStartCounter++;
-            break;
-        case adc_counter_running_st:
-            adcCounter++;
-            break;
-        case check_valid_move_st:
-            adcCounter = 0;
-            ticTacToeDisplay_touchScreenComputeBoardRowColumn(&(nextMove.row), &(nextMove.column)); // get the row and column touched by the player
-            break;
-        case player_move_st:
-            adcCounter = 0;
-            if (current_player_is_x) { // if the current player is X update the game with an X
-                gameBoard.squares[nextMove.row][nextMove.column] = MINIMAX_X_SQUARE; // put X in the gameBoard in the spot of the next move
-                ticTacToeDisplay_drawX(nextMove.row, nextMove.column, false); // draw the X on the display in the spot of the next move
-            }
-            else { // if the current player is O, updat the game with an O
-                gameBoard.squares[nextMove.row][nextMove.column] = MINIMAX_O_SQUARE; //  put O in the gameBoard in the spot of the next move
-                ticTacToeDisplay_drawO(nextMove.row, nextMove.column, false); // draw the O on the display in the spot of the next move
-            }
-            board_is_empty = false;
-            break;
-        case computer_move_st:
-            if (board_is_empty) { // if the board is empty, rather than recursing through minimax, play in the top left square
-                nextMove.row = TOP;
-                nextMove.column = LFT;
-            }
-            else // if the board is not empty, recurse through minimax as usual
-                minimax_computeNextMove(&gameBoard, current_player_is_x, &(nextMove.row), &(nextMove.column));
-            if (current_player_is_x) { // if the current player is X update the game with an X
-                gameBoard.squares[nextMove.row][nextMove.column] = MINIMAX_X_SQUARE; // put an W in the gameBoard in the spot of the next move
-                ticTacToeDisplay_drawX(nextMove.row, nextMove.column, false); // draw the X on the display in the spot of the next move
-            }
-            else { // if the current player is O, updat the game with an O
-                gameBoard.squares[nextMove.row][nextMove.column] = MINIMAX_O_SQUARE; //  put O in the gameBoard in the spot of the next move
-                ticTacToeDisplay_drawO(nextMove.row, nextMove.column, false); // draw the O on the display in the spot of the next move
-            }
-            board_is_empty = false;
-            break;
-        case waiting_for_player_st:
-            break;
-        case game_over_st:
-            playerStartCounter = 0;
-            board_is_empty = true;
-            // minimax_initBoard(&gameBoard); // reset the game board to all empty squares for next game
-            break;
-        default:
-            printf("ERROR\n"); // print an error message if the state machine is not in one of the defined states
-            break;
+// entry and state actions
+
+// helper function that forgets old button presses and prints the reports once per game
+static void gameOverEntry() {
+    inputSnapshot_flush(); // button presses from during the game don't start the next one
+    profiler_printReport();
+    tickMonitor_printReport();
+    displayQueue_printStats();
+    scheduler_printStats(); // prints nothing unless the machine runs under the scheduler
+    inputEvents_printStats();
+    touchInput_printStats();
+}
+
+// helper function that draws the start screen, only on the first tick
+static void startScreenTick() {
+    displayRetained_showScreen(START_SCREEN);
+}
+
+// helper function that erases the start screen and draws the board lines once
+static void blankBoardTick() {
+    displayRetained_showScreen(BOARD_SCREEN);
+}
+
+// helper function that gets the row and column touched by the player
+static void checkValidMoveTick() {
+    ticTacToeDisplay_touchScreenComputeBoardRowColumn(&(nextMove.row), &(nextMove.column));
+    touchInput_clear(); // the next move needs a new touch
+}
+
+// helper function that puts the current player's symbol at nextMove on the board and the display
+static void playNextMove() {
+    if (current_player_is_x) { // if the current player is X update the game with an X
+        gameBoard.squares[nextMove.row][nextMove.column] = MINIMAX_X_SQUARE; // put X in the gameBoard in the spot of the next move
+        ticTacToeDisplay_drawX(nextMove.row, nextMove.column, false); // draw the X on the display in the spot of the next move
+    }
+    else { // if the current player is O, updat the game with an O
+        gameBoard.squares[nextMove.row][nextMove.column] = MINIMAX_O_SQUARE; //  put O in the gameBoard in the spot of the next move
+        ticTacToeDisplay_drawO(nextMove.row, nextMove.column, false); // draw the O on the display in the spot of the next move
+    }
+    board_is_empty = false;
+}
+
+// helper function that picks the computer's move and plays it
+static void computerMoveTick() {
+    bool hints = hintsWanted();
+    hintScores = NULL;
+    if (board_is_empty) { // if the board is empty, rather than recursing through minimax, play in the top left square
+        nextMove.row = TOP;
+        nextMove.column = LFT;
+        if (hints)
+            hintScores = openingReplies;
+    }
+    else if (hints) { // pick the move as usual, then score the player's replies to it
+        minimax_computeNextMoveAndReplies(&gameBoard, current_player_is_x, &(nextMove.row), &(nextMove.column), moveReplies);
+        hintScores = moveReplies;
     }
+    else // if the board is not empty, recurse through minimax as usual
+        minimax_computeNextMove(&gameBoard, current_player_is_x, &(nextMove.row), &(nextMove.column));
+    playNextMove();
+}
+
+// helper function that marks the board empty for the next game
+static void gameOverTick() {
+    board_is_empty = true;
+}
+
+// transitions of each state, indexed by its select function
+static const fsm_transition_t initTransitions[] = {
+    {startGame, start_screen_st}
+};
+static const fsm_transition_t startScreenTransitions[] = {
+    {startPlayerTimer, blank_board_st}
+};
+static const fsm_transition_t blankBoardTransitions[] = {
+    [BLANK_TOUCHED] = {playerGoesFirst, adc_counter_running_st},
+    [BLANK_EXPIRED] = {NULL, computer_move_st}
+};
+static const fsm_transition_t adcCounterRunningTransitions[] = {
+    [ADC_SETTLED] = {NULL, check_valid_move_st},
+    [ADC_ABANDONED] = {NULL, waiting_for_player_st} // let go without a usable reading
+};
+static const fsm_transition_t checkValidMoveTransitions[] = {
+    [CHECK_EMPTY] = {ticTacToeHint_erase, player_move_st}, // the hints are stale once the player moves
+    [CHECK_TAKEN] = {NULL, waiting_for_player_st}
+};
+static const fsm_transition_t playerMoveTransitions[] = {
+    [MOVE_GAME_OVER] = {NULL, game_over_st},
+    [MOVE_NEXT_TURN] = {switchPlayer, computer_move_st}
+};
+static const fsm_transition_t computerMoveTransitions[] = {
+    [MOVE_GAME_OVER] = {NULL, game_over_st},
+    [MOVE_NEXT_TURN] = {switchToPlayer, waiting_for_player_st}
+};
+static const fsm_transition_t waitingForPlayerTransitions[] = {
+    {NULL, adc_counter_running_st}
+};
+static const fsm_transition_t gameOverTransitions[] = {
+    {resetGame, blank_board_st}
+};
+
+// select, entry, tick and exit actions and transitions of every state, in enum order
+static const fsm_state_t states[] = {
+    {NULL, NULL, NULL, NULL, FSM_TRANSITIONS(initTransitions)},
+    {startScreenSelect, NULL, startScreenTick, NULL, FSM_TRANSITIONS(startScreenTransitions)},
+    {blankBoardSelect, NULL, blankBoardTick, NULL, FSM_TRANSITIONS(blankBoardTransitions)},
+    {adcCounterRunningSelect, NULL, NULL, NULL, FSM_TRANSITIONS(adcCounterRunningTransitions)},
+    {checkValidMoveSelect, NULL, checkValidMoveTick, NULL, FSM_TRANSITIONS(checkValidMoveTransitions)},
+    {moveSelect, NULL, playNextMove, NULL, FSM_TRANSITIONS(playerMoveTransitions)},
+    {moveSelect, NULL, computerMoveTick, NULL, FSM_TRANSITIONS(computerMoveTransitions)},
+    {waitingForPlayerSelect, NULL, NULL, NULL, FSM_TRANSITIONS(waitingForPlayerTransitions)},
+    {gameOverSelect, gameOverEntry, gameOverTick, NULL, FSM_TRANSITIONS(gameOverTransitions)}
+};
+
+static const fsm_machine_t machine = {"ticTacToeControl", states, stateNames, sizeof(states) / sizeof(states[0]), init_st};
+
+// Tick the tic-tac-toe conroller state machine
+void ticTacToeControl_tick() {
+    tickMonitor_beginTick(monitorId);
+    profiler_enter("ticTacToeControl_tick");
+    timerWheel_update(); // bring every software timer up to date before reading any of them
+    inputSnapshot_update(); // every transition this tick sees the same debounced buttons and switches
+    touchInput_update(); // and the same touch
+    uint8_t fromState = fsm_tick(&fsm);
+
+    if (DISPLAYBUFFER_ENABLED) // push everything the symbols drew this tick in one pass
+        displayBuffer_flush();
+
+    uint32_t pixelsWritten = displayRetained_takePixelsWritten();
+    if (REPORT_PIXELS_PER_TICK && pixelsWritten) // idle ticks send nothing, so they print nothing
+        printf("ticTacToeControl: %lu pixels this tick\n", (unsigned long) pixelsWritten);
+    profiler_exit();
+    tickMonitor_endTick(monitorId, fromState, fsm.currentState);
 }
 
 // Initialize the tic-tac-toe conroller state machine
 void ticTacToeControl_init() {
-    currentState = init_st;
+    fsm_init(&fsm, &machine);
+    if (TRACE_TRANSITIONS)
+        fsm_setHook(&fsm, fsm_printTransition);
+    profiler_init();
+    minimax_board_t opening; // the computer always opens as X in the top left square
+    minimax_initBoard(&opening);
+    opening.squares[TOP][LFT] = MINIMAX_X_SQUARE;
+    minimax_computeMoveScores(&opening, false, openingReplies); // the biggest hint search, done once here instead of in a tick
+    timerWheel_init();
+    inputEvents_init();
+    inputSnapshot_init();
+    touchInput_init();
+    if (monitorId == TICKMONITOR_NO_MACHINE)
+        monitorId = tickMonitor_addMachine("ticTacToeControl", TICK_PERIOD_INTERRUPTS, stateNames, sizeof(stateNames) / sizeof(stateNames[0]));
+    displayRetained_init(DISPLAY_BLACK); // declare both screens once, nothing is drawn yet
+    displayRetained_declare(startScreen, START_SCREEN_ELEMENTS);
+    displayRetained_declare(boardScreen, BOARD_SCREEN_ELEMENTS);
+    if (DISPLAYBUFFER_ENABLED)
+        displayBuffer_init(DISPLAY_BLACK); // the panel starts out black
 }
\ No newline at end of file
@@ -0,0 +1,15 @@
+#ifndef TICTACTOEGEOMETRY_H_
+#define TICTACTOEGEOMETRY_H_
+
+// Where the tic-tac-toe board sits on the screen. The board lines are drawn
+// at one and two thirds of the display, BOARD_LINE_WIDTH wide, and the
+// squares lie between them. Everything that draws on the board or maps a
+// touch to a square takes its geometry from here.
+
+#define ONE_THIRD_DISPLAY_WIDTH 107
+#define TWO_THIRDS_DISPLAY_WIDTH 213
+#define ONE_THIRD_DISPLAY_HEIGHT 80
+#define TWO_THIRDS_DISPLAY_HEIGHT 160
+#define BOARD_LINE_WIDTH 1
+
+#endif /* TICTACTOEGEOMETRY_H_ */
@@ -0,0 +1,53 @@
+#include "ticTacToeHint.h"
+#include "minimaxScores.h"
+#include "display.h"
+#include "displayQueue.h"
+#include "ticTacToeGeometry.h"
+
+#define HINT_MARKER_OFFSET 4
+#define HINT_MARKER_SIZE 8
+
+// top left corner of each square, indexed by column and by row
+static const int16_t columnStart[MINIMAX_BOARD_COLUMNS] = {0, ONE_THIRD_DISPLAY_WIDTH, TWO_THIRDS_DISPLAY_WIDTH};
+static const int16_t rowStart[MINIMAX_BOARD_ROWS] = {0, ONE_THIRD_DISPLAY_HEIGHT, TWO_THIRDS_DISPLAY_HEIGHT};
+
+static bool markerDrawn[MINIMAX_BOARD_ROWS][MINIMAX_BOARD_COLUMNS]; // squares that currently show a marker
+
+// helper function to draw or erase the marker in one square
+static void drawMarker(uint8_t row, uint8_t column, uint16_t color) {
+    displayQueue_fillRect(columnStart[column] + HINT_MARKER_OFFSET, rowStart[row] + HINT_MARKER_OFFSET, HINT_MARKER_SIZE, HINT_MARKER_SIZE, color);
+}
+
+// Draws a small marker in the corner of every empty square showing the
+// score in scores of playing there for the side to move: green wins, yellow
+// draws, red loses. Any markers from the previous call are erased first.
+void ticTacToeHint_draw(const minimax_score_t scores[][MINIMAX_BOARD_COLUMNS], bool current_player_is_x) {
+    minimax_score_t winningScore = current_player_is_x ? MINIMAX_X_WINNING_SCORE : MINIMAX_O_WINNING_SCORE;
+
+    ticTacToeHint_erase(); // remove markers left over from the last position
+    for (uint8_t i = 0; i < MINIMAX_BOARD_ROWS; i++) { // for loop to move through each row
+        for (uint8_t j = 0; j < MINIMAX_BOARD_COLUMNS; j++) { // for loop to move through each column
+            if (scores[i][j] == MINIMAX_SCORES_ILLEGAL_MOVE) // no marker on taken squares
+                continue;
+            if (scores[i][j] == winningScore)
+                drawMarker(i, j, DISPLAY_GREEN);
+            else if (scores[i][j] == MINIMAX_DRAW_SCORE)
+                drawMarker(i, j, DISPLAY_YELLOW);
+            else
+                drawMarker(i, j, DISPLAY_RED);
+            markerDrawn[i][j] = true;
+        }
+    }
+}
+
+// Erases all hint markers that are currently on the display.
+void ticTacToeHint_erase() {
+    for (uint8_t i = 0; i < MINIMAX_BOARD_ROWS; i++) { // for loop to move through each row
+        for (uint8_t j = 0; j < MINIMAX_BOARD_COLUMNS; j++) { // for loop to move through each column
+            if (markerDrawn[i][j]) { // only touch the squares that have a marker
+                drawMarker(i, j, DISPLAY_BLACK);
+                markerDrawn[i][j] = false;
+            }
+        }
+    }
+}
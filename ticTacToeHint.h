@@ -0,0 +1,19 @@
+#ifndef TICTACTOEHINT_H_
+#define TICTACTOEHINT_H_
+
+#include "minimax.h"
+
+#include <stdbool.h>
+
+// Draws a small marker in the corner of every empty square showing the
+// score in scores of playing there for the side to move: green wins, yellow
+// draws, red loses. Taken squares hold MINIMAX_SCORES_ILLEGAL_MOVE and get
+// no marker. The scores are computed along with the computer's move
+// (minimax_computeNextMoveAndReplies), so drawing the hints searches
+// nothing. Any markers from the previous call are erased first.
+void ticTacToeHint_draw(const minimax_score_t scores[][MINIMAX_BOARD_COLUMNS], bool current_player_is_x);
+
+// Erases all hint markers that are currently on the display.
+void ticTacToeHint_erase();
+
+#endif /* TICTACTOEHINT_H_ */
@@ -0,0 +1,158 @@
+#include "ticTacToeSprites.h"
+#include "ticTacToeGeometry.h"
+#include "display.h"
+#include "displayBuffer.h"
+#include "displayQueue.h"
+
+#define BOARD_SIZE 3
+#define CIRCLE_RADIUS 27
+#define NUM_OF_BOARD_LINES 4
+
+// one horizontal run of a sprite, relative to the sprite's top left corner
+typedef struct {
+    uint8_t x, y, length;
+} span_t;
+
+typedef struct {
+    const span_t *spans;
+    uint8_t count;
+} sprite_t;
+
+// corners of each X and center of each O, indexed by column or by row
+static const int16_t xLeft[BOARD_SIZE] = {27, 134, 240};
+static const int16_t xTop[BOARD_SIZE] = {13, 93, 173};
+static const int16_t oCenterX[BOARD_SIZE] = {53, 160, 267};
+static const int16_t oCenterY[BOARD_SIZE] = {40, 120, 200};
+
+// inside of each square: first pixel and size, between the board lines
+static const int16_t cellLeft[BOARD_SIZE] = {0, ONE_THIRD_DISPLAY_WIDTH + BOARD_LINE_WIDTH, TWO_THIRDS_DISPLAY_WIDTH + BOARD_LINE_WIDTH};
+static const int16_t cellWidth[BOARD_SIZE] = {ONE_THIRD_DISPLAY_WIDTH, TWO_THIRDS_DISPLAY_WIDTH - ONE_THIRD_DISPLAY_WIDTH - BOARD_LINE_WIDTH, DISPLAY_WIDTH - TWO_THIRDS_DISPLAY_WIDTH - BOARD_LINE_WIDTH};
+static const int16_t cellTop[BOARD_SIZE] = {0, ONE_THIRD_DISPLAY_HEIGHT + BOARD_LINE_WIDTH, TWO_THIRDS_DISPLAY_HEIGHT + BOARD_LINE_WIDTH};
+static const int16_t cellHeight[BOARD_SIZE] = {ONE_THIRD_DISPLAY_HEIGHT, TWO_THIRDS_DISPLAY_HEIGHT - ONE_THIRD_DISPLAY_HEIGHT - BOARD_LINE_WIDTH, DISPLAY_HEIGHT - TWO_THIRDS_DISPLAY_HEIGHT - BOARD_LINE_WIDTH};
+
+// Span tables for the symbols, in row order. They are the exact pixels the
+// driver's display_drawLine (the two diagonals from each X corner, 53 or 52
+// wide and 54 tall) and display_drawCircle (radius 27) would plot, merged
+// into horizontal runs, so nothing is rasterized at run time. The X is one
+// pixel narrower in the middle column, so each column has its own table.
+static const span_t xLeftSpans[] = {
+    {0, 0, 1}, {53, 0, 1}, {1, 1, 1}, {52, 1, 1}, {2, 2, 1}, {51, 2, 1}, {3, 3, 1}, {50, 3, 1},
+    {4, 4, 1}, {49, 4, 1}, {5, 5, 1}, {48, 5, 1}, {6, 6, 1}, {47, 6, 1}, {7, 7, 1}, {46, 7, 1},
+    {8, 8, 1}, {45, 8, 1}, {9, 9, 1}, {44, 9, 1}, {10, 10, 1}, {43, 10, 1}, {11, 11, 1}, {42, 11, 1},
+    {12, 12, 1}, {41, 12, 1}, {13, 13, 1}, {40, 13, 1}, {14, 14, 1}, {39, 14, 1}, {15, 15, 1}, {38, 15, 1},
+    {16, 16, 1}, {37, 16, 1}, {17, 17, 1}, {36, 17, 1}, {18, 18, 1}, {35, 18, 1}, {19, 19, 1}, {34, 19, 1},
+    {20, 20, 1}, {33, 20, 1}, {21, 21, 1}, {32, 21, 1}, {22, 22, 1}, {31, 22, 1}, {23, 23, 1}, {30, 23, 1},
+    {24, 24, 1}, {29, 24, 1}, {25, 25, 1}, {28, 25, 1}, {26, 26, 2}, {26, 27, 2}, {26, 28, 2}, {25, 29, 1},
+    {28, 29, 1}, {24, 30, 1}, {29, 30, 1}, {23, 31, 1}, {30, 31, 1}, {22, 32, 1}, {31, 32, 1}, {21, 33, 1},
+    {32, 33, 1}, {20, 34, 1}, {33, 34, 1}, {19, 35, 1}, {34, 35, 1}, {18, 36, 1}, {35, 36, 1}, {17, 37, 1},
+    {36, 37, 1}, {16, 38, 1}, {37, 38, 1}, {15, 39, 1}, {38, 39, 1}, {14, 40, 1}, {39, 40, 1}, {13, 41, 1},
+    {40, 41, 1}, {12, 42, 1}, {41, 42, 1}, {11, 43, 1}, {42, 43, 1}, {10, 44, 1}, {43, 44, 1}, {9, 45, 1},
+    {44, 45, 1}, {8, 46, 1}, {45, 46, 1}, {7, 47, 1}, {46, 47, 1}, {6, 48, 1}, {47, 48, 1}, {5, 49, 1},
+    {48, 49, 1}, {4, 50, 1}, {49, 50, 1}, {3, 51, 1}, {50, 51, 1}, {2, 52, 1}, {51, 52, 1}, {1, 53, 1},
+    {52, 53, 1}, {0, 54, 1}, {53, 54, 1}
+};
+static const span_t xMiddleSpans[] = {
+    {0, 0, 1}, {52, 0, 1}, {1, 1, 1}, {51, 1, 1}, {2, 2, 1}, {50, 2, 1}, {3, 3, 1}, {49, 3, 1},
+    {4, 4, 1}, {48, 4, 1}, {5, 5, 1}, {47, 5, 1}, {6, 6, 1}, {46, 6, 1}, {7, 7, 1}, {45, 7, 1},
+    {8, 8, 1}, {44, 8, 1}, {9, 9, 1}, {43, 9, 1}, {10, 10, 1}, {42, 10, 1}, {11, 11, 1}, {41, 11, 1},
+    {12, 12, 1}, {40, 12, 1}, {13, 13, 1}, {39, 13, 1}, {13, 14, 1}, {39, 14, 1}, {14, 15, 1}, {38, 15, 1},
+    {15, 16, 1}, {37, 16, 1}, {16, 17, 1}, {36, 17, 1}, {17, 18, 1}, {35, 18, 1}, {18, 19, 1}, {34, 19, 1},
+    {19, 20, 1}, {33, 20, 1}, {20, 21, 1}, {32, 21, 1}, {21, 22, 1}, {31, 22, 1}, {22, 23, 1}, {30, 23, 1},
+    {23, 24, 1}, {29, 24, 1}, {24, 25, 1}, {28, 25, 1}, {25, 26, 1}, {27, 26, 1}, {26, 27, 1}, {25, 28, 1},
+    {27, 28, 1}, {24, 29, 1}, {28, 29, 1}, {23, 30, 1}, {29, 30, 1}, {22, 31, 1}, {30, 31, 1}, {21, 32, 1},
+    {31, 32, 1}, {20, 33, 1}, {32, 33, 1}, {19, 34, 1}, {33, 34, 1}, {18, 35, 1}, {34, 35, 1}, {17, 36, 1},
+    {35, 36, 1}, {16, 37, 1}, {36, 37, 1}, {15, 38, 1}, {37, 38, 1}, {14, 39, 1}, {38, 39, 1}, {13, 40, 1},
+    {39, 40, 1}, {13, 41, 1}, {39, 41, 1}, {12, 42, 1}, {40, 42, 1}, {11, 43, 1}, {41, 43, 1}, {10, 44, 1},
+    {42, 44, 1}, {9, 45, 1}, {43, 45, 1}, {8, 46, 1}, {44, 46, 1}, {7, 47, 1}, {45, 47, 1}, {6, 48, 1},
+    {46, 48, 1}, {5, 49, 1}, {47, 49, 1}, {4, 50, 1}, {48, 50, 1}, {3, 51, 1}, {49, 51, 1}, {2, 52, 1},
+    {50, 52, 1}, {1, 53, 1}, {51, 53, 1}, {0, 54, 1}, {52, 54, 1}
+};
+static const span_t xRightSpans[] = {
+    {0, 0, 1}, {53, 0, 1}, {1, 1, 1}, {52, 1, 1}, {2, 2, 1}, {51, 2, 1}, {3, 3, 1}, {50, 3, 1},
+    {4, 4, 1}, {49, 4, 1}, {5, 5, 1}, {48, 5, 1}, {6, 6, 1}, {47, 6, 1}, {7, 7, 1}, {46, 7, 1},
+    {8, 8, 1}, {45, 8, 1}, {9, 9, 1}, {44, 9, 1}, {10, 10, 1}, {43, 10, 1}, {11, 11, 1}, {42, 11, 1},
+    {12, 12, 1}, {41, 12, 1}, {13, 13, 1}, {40, 13, 1}, {14, 14, 1}, {39, 14, 1}, {15, 15, 1}, {38, 15, 1},
+    {16, 16, 1}, {37, 16, 1}, {17, 17, 1}, {36, 17, 1}, {18, 18, 1}, {35, 18, 1}, {19, 19, 1}, {34, 19, 1},
+    {20, 20, 1}, {33, 20, 1}, {21, 21, 1}, {32, 21, 1}, {22, 22, 1}, {31, 22, 1}, {23, 23, 1}, {30, 23, 1},
+    {24, 24, 1}, {29, 24, 1}, {25, 25, 1}, {28, 25, 1}, {26, 26, 2}, {26, 27, 2}, {26, 28, 2}, {25, 29, 1},
+    {28, 29, 1}, {24, 30, 1}, {29, 30, 1}, {23, 31, 1}, {30, 31, 1}, {22, 32, 1}, {31, 32, 1}, {21, 33, 1},
+    {32, 33, 1}, {20, 34, 1}, {33, 34, 1}, {19, 35, 1}, {34, 35, 1}, {18, 36, 1}, {35, 36, 1}, {17, 37, 1},
+    {36, 37, 1}, {16, 38, 1}, {37, 38, 1}, {15, 39, 1}, {38, 39, 1}, {14, 40, 1}, {39, 40, 1}, {13, 41, 1},
+    {40, 41, 1}, {12, 42, 1}, {41, 42, 1}, {11, 43, 1}, {42, 43, 1}, {10, 44, 1}, {43, 44, 1}, {9, 45, 1},
+    {44, 45, 1}, {8, 46, 1}, {45, 46, 1}, {7, 47, 1}, {46, 47, 1}, {6, 48, 1}, {47, 48, 1}, {5, 49, 1},
+    {48, 49, 1}, {4, 50, 1}, {49, 50, 1}, {3, 51, 1}, {50, 51, 1}, {2, 52, 1}, {51, 52, 1}, {1, 53, 1},
+    {52, 53, 1}, {0, 54, 1}, {53, 54, 1}
+};
+static const span_t oSpans[] = {
+    {22, 0, 11}, {19, 1, 3}, {33, 1, 3}, {16, 2, 3}, {36, 2, 3}, {14, 3, 2}, {39, 3, 2}, {13, 4, 1},
+    {41, 4, 1}, {11, 5, 2}, {42, 5, 2}, {10, 6, 1}, {44, 6, 1}, {9, 7, 1}, {45, 7, 1}, {8, 8, 1},
+    {46, 8, 1}, {7, 9, 1}, {47, 9, 1}, {6, 10, 1}, {48, 10, 1}, {5, 11, 1}, {49, 11, 1}, {5, 12, 1},
+    {49, 12, 1}, {4, 13, 1}, {50, 13, 1}, {3, 14, 1}, {51, 14, 1}, {3, 15, 1}, {51, 15, 1}, {2, 16, 1},
+    {52, 16, 1}, {2, 17, 1}, {52, 17, 1}, {2, 18, 1}, {52, 18, 1}, {1, 19, 1}, {53, 19, 1}, {1, 20, 1},
+    {53, 20, 1}, {1, 21, 1}, {53, 21, 1}, {0, 22, 1}, {54, 22, 1}, {0, 23, 1}, {54, 23, 1}, {0, 24, 1},
+    {54, 24, 1}, {0, 25, 1}, {54, 25, 1}, {0, 26, 1}, {54, 26, 1}, {0, 27, 1}, {54, 27, 1}, {0, 28, 1},
+    {54, 28, 1}, {0, 29, 1}, {54, 29, 1}, {0, 30, 1}, {54, 30, 1}, {0, 31, 1}, {54, 31, 1}, {0, 32, 1},
+    {54, 32, 1}, {1, 33, 1}, {53, 33, 1}, {1, 34, 1}, {53, 34, 1}, {1, 35, 1}, {53, 35, 1}, {2, 36, 1},
+    {52, 36, 1}, {2, 37, 1}, {52, 37, 1}, {2, 38, 1}, {52, 38, 1}, {3, 39, 1}, {51, 39, 1}, {3, 40, 1},
+    {51, 40, 1}, {4, 41, 1}, {50, 41, 1}, {5, 42, 1}, {49, 42, 1}, {5, 43, 1}, {49, 43, 1}, {6, 44, 1},
+    {48, 44, 1}, {7, 45, 1}, {47, 45, 1}, {8, 46, 1}, {46, 46, 1}, {9, 47, 1}, {45, 47, 1}, {10, 48, 1},
+    {44, 48, 1}, {11, 49, 2}, {42, 49, 2}, {13, 50, 1}, {41, 50, 1}, {14, 51, 2}, {39, 51, 2}, {16, 52, 3},
+    {36, 52, 3}, {19, 53, 3}, {33, 53, 3}, {22, 54, 11}
+};
+
+#define SPAN_COUNT(spans) (sizeof(spans) / sizeof(spans[0]))
+
+static const sprite_t xSprites[BOARD_SIZE] = {{xLeftSpans, SPAN_COUNT(xLeftSpans)}, {xMiddleSpans, SPAN_COUNT(xMiddleSpans)}, {xRightSpans, SPAN_COUNT(xRightSpans)}};
+static const sprite_t oSprite = {oSpans, SPAN_COUNT(oSpans)};
+
+// the four board lines as solid runs: x, y, width, height
+static const int16_t boardLines[NUM_OF_BOARD_LINES][4] = {
+    {0, ONE_THIRD_DISPLAY_HEIGHT, DISPLAY_WIDTH, BOARD_LINE_WIDTH}, // upper horizontal line
+    {0, TWO_THIRDS_DISPLAY_HEIGHT, DISPLAY_WIDTH, BOARD_LINE_WIDTH}, // lower horizontal line
+    {ONE_THIRD_DISPLAY_WIDTH, 0, BOARD_LINE_WIDTH, DISPLAY_HEIGHT}, // left vertical line
+    {TWO_THIRDS_DISPLAY_WIDTH, 0, BOARD_LINE_WIDTH, DISPLAY_HEIGHT} // right vertical line
+};
+
+// helper function that fills one solid rectangle on the back buffer or the panel
+static void fillRun(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (DISPLAYBUFFER_ENABLED) // draw into the back buffer, the controller flushes it once per tick
+        displayBuffer_fillRect(x, y, w, h, color);
+    else
+        displayQueue_fillRect(x, y, w, h, color);
+}
+
+// helper function that draws a sprite with its top left corner at (x, y)
+static void drawSprite(const sprite_t *sprite, int16_t x, int16_t y, uint16_t color) {
+    for (uint8_t i = 0; i < sprite->count; i++) {
+        if (DISPLAYBUFFER_ENABLED)
+            displayBuffer_drawFastHLine(x + sprite->spans[i].x, y + sprite->spans[i].y, sprite->spans[i].length, color);
+        else
+            displayQueue_drawFastHLine(x + sprite->spans[i].x, y + sprite->spans[i].y, sprite->spans[i].length, color);
+    }
+}
+
+// Draws the four board lines, one contiguous run each.
+void ticTacToeSprites_drawBoardLines(uint16_t color) {
+    for (uint8_t i = 0; i < NUM_OF_BOARD_LINES; i++)
+        fillRun(boardLines[i][0], boardLines[i][1], boardLines[i][2], boardLines[i][3], color);
+}
+
+// Draws (or erases, with the background color) the X in one square.
+void ticTacToeSprites_drawX(uint8_t row, uint8_t column, uint16_t color) {
+    drawSprite(&xSprites[column], xLeft[column], xTop[row], color);
+}
+
+// Draws (or erases, with the background color) the O in one square.
+void ticTacToeSprites_drawO(uint8_t row, uint8_t column, uint16_t color) {
+    drawSprite(&oSprite, oCenterX[column] - CIRCLE_RADIUS, oCenterY[row] - CIRCLE_RADIUS, color);
+}
+
+// Fills the inside of all 9 squares with color in one pass. The board lines
+// are between the squares and are not touched.
+void ticTacToeSprites_clearAllCells(uint16_t color) {
+    for (uint8_t row = 0; row < BOARD_SIZE; row++) {
+        for (uint8_t column = 0; column < BOARD_SIZE; column++) {
+            fillRun(cellLeft[column], cellTop[row], cellWidth[column], cellHeight[row], color);
+        }
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef TICTACTOESPRITES_H_
+#define TICTACTOESPRITES_H_
+
+#include <stdint.h>
+
+// Span tables for the tic-tac-toe screen. Every X and the O are stored as
+// constant lists of horizontal spans, and the square positions live in
+// lookup tables, so drawing or erasing a symbol is a short loop of
+// display_drawFastHLine calls with no line or circle math. The board lines
+// are one solid run each.
+
+// Draws the four board lines.
+void ticTacToeSprites_drawBoardLines(uint16_t color);
+
+// Draws (or erases, with the background color) the X or O in one square.
+void ticTacToeSprites_drawX(uint8_t row, uint8_t column, uint16_t color);
+void ticTacToeSprites_drawO(uint8_t row, uint8_t column, uint16_t color);
+
+// Fills the inside of all 9 squares with color in one pass. The board lines
+// are between the squares and are not touched.
+void ticTacToeSprites_clearAllCells(uint16_t color);
+
+#endif /* TICTACTOESPRITES_H_ */
@@ -0,0 +1,150 @@
+#include "tickMonitor.h"
+#include "intervalTimer.h"
+#include "scheduler.h"
+#include "timestamp.h"
+
+#include <stdio.h>
+
+#define TOP_BIT 31
+
+typedef struct {
+    uint32_t count;
+    uint32_t worstUs;
+    uint8_t worstFrom; // state the worst tick started in
+    uint32_t histogram[TICKMONITOR_BUCKETS];
+} state_stats_t;
+
+typedef struct {
+    const char *name;
+    const char *const *stateNames;
+    uint8_t stateCount;
+    uint16_t periodInterrupts;
+    uint32_t ticks;
+    uint32_t overruns; // ticks that started more than one period after the last, or ran longer than a period
+    uint32_t worstLatencyUs, worstRunUs;
+    uint32_t latency[TICKMONITOR_BUCKETS];
+    uint32_t run[TICKMONITOR_BUCKETS];
+    uint32_t lastStartInterrupt; // interrupt count when the previous tick started
+    bool lastTickOverran; // already counted, so the late start that follows isn't counted again
+    uint64_t startTicks;
+    state_stats_t states[TICKMONITOR_MAX_STATES];
+} machine_t;
+
+static machine_t machines[TICKMONITOR_MAX_MACHINES];
+static uint8_t machineCount;
+static timestamp_handle_t timer;
+static volatile uint32_t interruptCount;
+static volatile uint64_t lastInterruptTicks;
+
+// helper function that reads the time of the latest interrupt; the ISR
+// writes it in two halves, so read until two reads agree
+static uint64_t readLastInterruptTicks() {
+    uint64_t ticks;
+    do
+        ticks = lastInterruptTicks;
+    while (ticks != lastInterruptTicks);
+    return ticks;
+}
+
+// helper function that adds a duration to a log2 histogram
+static void record(uint32_t *histogram, uint32_t us) {
+    uint8_t bucket = TOP_BIT - __builtin_clz(us | 1);
+    histogram[(bucket < TICKMONITOR_BUCKETS) ? bucket : TICKMONITOR_BUCKETS - 1]++;
+}
+
+// helper function that prints the non-empty buckets of a histogram
+static void printHistogram(const char *label, const uint32_t *histogram) {
+    printf("    %s us:", label);
+    for (uint8_t b = 0; b < TICKMONITOR_BUCKETS; b++)
+        if (histogram[b])
+            printf(" %s%lu:%lu", (b == TICKMONITOR_BUCKETS - 1) ? ">=" : "", 1UL << b, (unsigned long) histogram[b]);
+    printf("\n");
+}
+
+// Registers a state machine that ticks every periodInterrupts timer
+// interrupts. stateNames[i] names state i and must stay valid.
+// Returns the id to pass to the other calls, or TICKMONITOR_NO_MACHINE.
+uint8_t tickMonitor_addMachine(const char *name, uint16_t periodInterrupts, const char *const *stateNames, uint8_t stateCount) {
+    if (!TICKMONITOR_ENABLED || (machineCount == TICKMONITOR_MAX_MACHINES) || (stateCount > TICKMONITOR_MAX_STATES))
+        return TICKMONITOR_NO_MACHINE;
+    timer = timestamp_startTimer(TICKMONITOR_TIMER);
+    machine_t *machine = &machines[machineCount];
+    machine->name = name;
+    machine->stateNames = stateNames;
+    machine->stateCount = stateCount;
+    machine->periodInterrupts = periodInterrupts;
+    machine->lastStartInterrupt = interruptCount;
+    return machineCount++;
+}
+
+// Marks a timer interrupt; call first thing in isr_function.
+void tickMonitor_interruptEntry() {
+    if (!TICKMONITOR_ENABLED || !machineCount)
+        return;
+    lastInterruptTicks = timestamp_read(timer);
+    interruptCount++;
+}
+
+// Call at the very start of a tick.
+void tickMonitor_beginTick(uint8_t machine) {
+    if (!TICKMONITOR_ENABLED || (machine >= machineCount))
+        return;
+    machine_t *m = &machines[machine];
+    m->startTicks = timestamp_read(timer);
+    uint64_t releaseTicks;
+    if (!scheduler_getReleaseTicks(&releaseTicks)) // not run by the scheduler: the latest interrupt is the best guess
+        releaseTicks = readLastInterruptTicks();
+    uint32_t latencyUs = timestamp_toMicroseconds(m->startTicks - releaseTicks);
+    record(m->latency, latencyUs);
+    if (latencyUs > m->worstLatencyUs)
+        m->worstLatencyUs = latencyUs;
+    if (m->ticks && !m->lastTickOverran && (interruptCount - m->lastStartInterrupt > m->periodInterrupts)) // a release was missed
+        m->overruns++;
+    m->lastStartInterrupt = interruptCount;
+}
+
+// Call at the very end of a tick with the state it started in and the
+// state it ended in.
+void tickMonitor_endTick(uint8_t machine, uint8_t fromState, uint8_t toState) {
+    if (!TICKMONITOR_ENABLED || (machine >= machineCount))
+        return;
+    machine_t *m = &machines[machine];
+    uint32_t runUs = timestamp_toMicroseconds(timestamp_read(timer) - m->startTicks);
+    m->ticks++;
+    record(m->run, runUs);
+    if (runUs > m->worstRunUs)
+        m->worstRunUs = runUs;
+    m->lastTickOverran = (interruptCount - m->lastStartInterrupt >= m->periodInterrupts); // still running when the next release came
+    if (m->lastTickOverran)
+        m->overruns++;
+    if (toState >= m->stateCount)
+        return;
+    state_stats_t *state = &m->states[toState]; // the tick's actions ran for the state it ended in
+    state->count++;
+    record(state->histogram, runUs);
+    if ((state->count == 1) || (runUs > state->worstUs)) {
+        state->worstUs = runUs;
+        state->worstFrom = fromState;
+    }
+}
+
+// Prints the histograms and the worst case of every state.
+void tickMonitor_printReport() {
+    if (!TICKMONITOR_ENABLED)
+        return;
+    for (uint8_t i = 0; i < machineCount; i++) {
+        machine_t *m = &machines[i];
+        printf("%s: %lu ticks, %lu overruns, worst latency %lu us, worst run %lu us\n", m->name, (unsigned long) m->ticks, (unsigned long) m->overruns,
+               (unsigned long) m->worstLatencyUs, (unsigned long) m->worstRunUs);
+        printHistogram("latency", m->latency);
+        printHistogram("run", m->run);
+        for (uint8_t s = 0; s < m->stateCount; s++) {
+            state_stats_t *state = &m->states[s];
+            if (!state->count)
+                continue;
+            printf("  %-24s %8lu ticks, worst %6lu us (from %s)\n", m->stateNames[s], (unsigned long) state->count, (unsigned long) state->worstUs,
+                   (state->worstFrom < m->stateCount) ? m->stateNames[state->worstFrom] : "?");
+            printHistogram("run", state->histogram);
+        }
+    }
+}
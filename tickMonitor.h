@@ -0,0 +1,49 @@
+#ifndef TICKMONITOR_H_
+#define TICKMONITOR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Timing monitor for the tick functions. isr_function marks each timer
+// interrupt; every state machine brackets its tick with
+// tickMonitor_beginTick / tickMonitor_endTick. From the interval-timer
+// timestamps the monitor keeps, per state machine, histograms of the
+// release-to-start latency and of the run time,
+// plus overruns, and per state the run times of the ticks that ended in it
+// with the transition that produced the worst one.
+//
+// Latency is measured from the scheduler's release of the task running the
+// tick, or from the latest timer interrupt when the tick is called outside
+// the scheduler.
+//
+// Histograms are log2 of microseconds: bucket b counts 2^b to 2^(b+1)-1 us,
+// and the last bucket everything longer.
+
+// set to 1 to turn the monitor on; at 0 every call returns right away
+#define TICKMONITOR_ENABLED 0
+
+#define TICKMONITOR_TIMER INTERVAL_TIMER_TIMER_1 // only read, shared with the timer wheel and the scheduler
+#define TICKMONITOR_MAX_MACHINES 4
+#define TICKMONITOR_MAX_STATES 16
+#define TICKMONITOR_BUCKETS 16
+#define TICKMONITOR_NO_MACHINE 0xFF
+
+// Registers a state machine that ticks every periodInterrupts timer
+// interrupts. stateNames[i] names state i and must stay valid.
+// Returns the id to pass to the other calls, or TICKMONITOR_NO_MACHINE.
+uint8_t tickMonitor_addMachine(const char *name, uint16_t periodInterrupts, const char *const *stateNames, uint8_t stateCount);
+
+// Marks a timer interrupt; call first thing in isr_function.
+void tickMonitor_interruptEntry();
+
+// Call at the very start of a tick.
+void tickMonitor_beginTick(uint8_t machine);
+
+// Call at the very end of a tick with the state it started in and the
+// state it ended in.
+void tickMonitor_endTick(uint8_t machine, uint8_t fromState, uint8_t toState);
+
+// Prints the histograms and the worst case of every state.
+void tickMonitor_printReport();
+
+#endif /* TICKMONITOR_H_ */
@@ -0,0 +1,157 @@
+#include "timerDelay.h"
+#include "inputEvents.h"
+#include "intervalTimer.h"
+#include "timestamp.h"
+#include "xtime_l.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define NS_PER_SECOND 1000000000ULL
+#define US_PER_SECOND 1000000ULL
+#define MS_PER_SECOND 1000ULL
+#define PPM 1000000LL
+
+static bool calibrated;
+static timestamp_handle_t timer;
+static uint32_t frequency = TIMESTAMP_TICKS_PER_SECOND; // measured by timerDelay_init
+static uint32_t spinNs; // how long TIMERDELAY_SPIN_LOOPS turns of the spin loop take
+
+static uint32_t delayCount;
+static uint32_t spinCount;
+static uint64_t requestedTicks;
+static uint64_t overshootTicks;
+static uint32_t worstOvershootTicks;
+static uint64_t pollTicks;
+static uint64_t sleepTicks;
+
+// helper function that turns the spin loop; volatile keeps the compiler from removing it
+static void spin(uint32_t loops) {
+    for (volatile uint32_t i = loops; i; i--)
+        ;
+}
+
+// helper function that measures the timer against the ARM global timer, which runs from the CPU clock
+static uint32_t measureFrequency() {
+    XTime globalStart, globalNow;
+    XTime_GetTime(&globalStart);
+    uint64_t start = timestamp_read(timer);
+    XTime window = COUNTS_PER_SECOND / MS_PER_SECOND * TIMERDELAY_CALIBRATION_MS;
+    do
+        XTime_GetTime(&globalNow);
+    while (globalNow - globalStart < window);
+    uint64_t ticks = timestamp_read(timer) - start;
+    return (uint32_t) (ticks * COUNTS_PER_SECOND / (globalNow - globalStart));
+}
+
+// helper function that converts timer ticks to units at the measured frequency;
+// whole seconds and the rest are scaled apart so no product overflows 64 bits
+static uint64_t ticksToUnits(uint64_t ticks, uint64_t unitsPerSecond) {
+    return (ticks / frequency) * unitsPerSecond + (ticks % frequency) * unitsPerSecond / frequency;
+}
+
+// helper function that converts timer ticks to nanoseconds at the measured frequency
+static uint64_t ticksToNs(uint64_t ticks) {
+    return ticksToUnits(ticks, NS_PER_SECOND);
+}
+
+// helper function that converts timer ticks to milliseconds at the measured frequency
+static uint64_t ticksToMs(uint64_t ticks) {
+    return ticksToUnits(ticks, MS_PER_SECOND);
+}
+
+// helper function that waits until ticks have passed since start, sleeping
+// while more than one interrupt period is left if sleeping is allowed and
+// the timer interrupt is running to wake us
+static void waitFor(uint64_t start, uint64_t ticks, bool maySleep) {
+    uint64_t deadline = start + ticks;
+    uint64_t margin = (uint64_t) frequency / MS_PER_SECOND * TIMERDELAY_SLEEP_MIN_MS;
+    uint64_t sleepUntil = (ticks > margin) ? deadline - margin : start;
+    uint64_t now = start;
+    if (INPUTEVENTS_ENABLED && maySleep && inputEvents_isInterruptRunning()) {
+        while (now < sleepUntil) { // each interrupt wakes us; the scheduler's tick comes every period
+            inputEvents_idle(NULL);
+            uint64_t woke = timestamp_read(timer);
+            sleepTicks += woke - now;
+            now = woke;
+        }
+    }
+    uint64_t pollStart = now;
+    while (now < deadline)
+        now = timestamp_read(timer);
+    pollTicks += now - pollStart;
+
+    uint32_t overshoot = now - deadline;
+    delayCount++;
+    requestedTicks += ticks;
+    overshootTicks += overshoot;
+    if (overshoot > worstOvershootTicks)
+        worstOvershootTicks = overshoot;
+}
+
+// Measures the timer frequency and calibrates the spin loop, and prints both.
+void timerDelay_init() {
+    if (calibrated)
+        return;
+    timer = timestamp_startTimer(TIMERDELAY_TIMER);
+    frequency = measureFrequency();
+
+    spin(TIMERDELAY_SPIN_LOOPS); // warm the caches so the measured run is typical
+    uint64_t start = timestamp_read(timer);
+    spin(TIMERDELAY_SPIN_LOOPS);
+    spinNs = ticksToNs(timestamp_read(timer) - start);
+    if (!spinNs)
+        spinNs = 1;
+    calibrated = true;
+
+    int64_t errorPpm = ((int64_t) frequency - TIMESTAMP_TICKS_PER_SECOND) * PPM / TIMESTAMP_TICKS_PER_SECOND;
+    printf("timerDelay: timer runs at %lu Hz, %ld ppm from the nominal %lu Hz; %lu spin loops take %lu ns\n", (unsigned long) frequency, (long) errorPpm,
+           (unsigned long) TIMESTAMP_TICKS_PER_SECOND, (unsigned long) TIMERDELAY_SPIN_LOOPS, (unsigned long) spinNs);
+}
+
+// Waits ns nanoseconds with the calibrated spin loop, or on the timer if
+// the delay is long enough to time.
+void timerDelay_ns(uint32_t ns) {
+    timerDelay_init();
+    if (ns >= TIMERDELAY_SPIN_LIMIT_NS) { // also keeps the loop count below from overflowing
+        uint64_t start = timestamp_read(timer);
+        waitFor(start, (uint64_t) ns * frequency / NS_PER_SECOND, false);
+        return;
+    }
+    spin((uint64_t) ns * TIMERDELAY_SPIN_LOOPS / spinNs);
+    spinCount++;
+}
+
+// Waits us microseconds.
+void timerDelay_us(uint32_t us) {
+    timerDelay_init();
+    if ((uint64_t) us * (NS_PER_SECOND / US_PER_SECOND) < TIMERDELAY_SPIN_LIMIT_NS) { // too short for register reads to time
+        timerDelay_ns(us * (NS_PER_SECOND / US_PER_SECOND));
+        return;
+    }
+    uint64_t start = timestamp_read(timer);
+    waitFor(start, (uint64_t) us * frequency / US_PER_SECOND, false);
+}
+
+// Waits ms milliseconds, sleeping through most of it when it can.
+void timerDelay_ms(uint32_t ms) {
+    timerDelay_init();
+    uint64_t start = timestamp_read(timer);
+    waitFor(start, (uint64_t) ms * frequency / MS_PER_SECOND, true);
+}
+
+// Returns the measured timer frequency in Hz.
+uint32_t timerDelay_getFrequency() {
+    return frequency;
+}
+
+// Prints delays, their average and worst overshoot, and the time spent polling and sleeping.
+void timerDelay_printStats() {
+    uint64_t waited = pollTicks + sleepTicks;
+    uint32_t sleepPermille = waited ? (uint32_t) (sleepTicks * 1000 / waited) : 0;
+    printf("timerDelay: %lu timed delays (%lu ms asked), overshoot average %lu ns worst %lu ns; %lu spin delays\n", (unsigned long) delayCount,
+           (unsigned long) ticksToMs(requestedTicks), (unsigned long) (delayCount ? ticksToNs(overshootTicks / delayCount) : 0),
+           (unsigned long) ticksToNs(worstOvershootTicks), (unsigned long) spinCount);
+    printf("timerDelay: %lu ms polling, %lu ms asleep (%lu.%lu%% of the waiting)\n", (unsigned long) ticksToMs(pollTicks),
+           (unsigned long) ticksToMs(sleepTicks), (unsigned long) sleepPermille / 10, (unsigned long) sleepPermille % 10);
+}
@@ -0,0 +1,50 @@
+#ifndef TIMERDELAY_H_
+#define TIMERDELAY_H_
+
+#include <stdint.h>
+
+// Delays timed by the free-running interval timer instead of a busy loop of
+// guessed length. At startup the timer's real frequency is measured
+// against the ARM global timer and compared with
+// XPAR_AXI_TIMER_0_CLOCK_FREQ_HZ, and a spin loop is calibrated against the
+// timer for delays too short to time with register reads.
+//
+//  - below TIMERDELAY_SPIN_LIMIT_NS: the calibrated spin loop
+//  - up to TIMERDELAY_SLEEP_MIN_MS: polling the timer until the deadline
+//  - longer: sleeping with WFI until the last interrupt period before the
+//    deadline, then polling (sleeping needs INPUTEVENTS_ENABLED and the
+//    timer interrupt running, see inputEvents_isInterruptRunning;
+//    otherwise it polls the whole way)
+//
+// Every delay's overshoot and the time spent spinning and sleeping are
+// counted for timerDelay_printStats.
+
+#define TIMERDELAY_TIMER INTERVAL_TIMER_TIMER_1 // only read, shared with the timer wheel and the scheduler
+#define TIMERDELAY_CALIBRATION_MS 100
+#define TIMERDELAY_SPIN_LOOPS 100000 // length of the spin loop calibration
+#define TIMERDELAY_SPIN_LIMIT_NS 2000
+#define TIMERDELAY_SLEEP_MIN_MS 10 // the timer interrupt period: shorter waits can't sleep
+
+// Measures the timer frequency and calibrates the spin loop, and prints
+// both. Only the first call does anything.
+void timerDelay_init();
+
+// Waits ns nanoseconds with the calibrated spin loop. Meant for short
+// delays; the loop's accuracy is a few percent. From
+// TIMERDELAY_SPIN_LIMIT_NS up the delay is timed on the timer instead.
+void timerDelay_ns(uint32_t ns);
+
+// Waits us microseconds.
+void timerDelay_us(uint32_t us);
+
+// Waits ms milliseconds, sleeping through most of it when it can.
+void timerDelay_ms(uint32_t ms);
+
+// Returns the measured timer frequency in Hz.
+uint32_t timerDelay_getFrequency();
+
+// Prints delays, their average and worst overshoot, and the time spent
+// polling and sleeping.
+void timerDelay_printStats();
+
+#endif /* TIMERDELAY_H_ */
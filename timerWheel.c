@@ -0,0 +1,126 @@
+#include "timerWheel.h"
+#include "intervalTimer.h"
+#include "timestamp.h"
+
+#include <stddef.h>
+
+#define SLOTS (1 << TIMERWHEEL_SLOT_BITS)
+#define SLOT_MASK (SLOTS - 1)
+#define HARDWARE_TICKS_PER_MS (TIMESTAMP_TICKS_PER_SECOND / 1000)
+#define MAX_DELTA ((1UL << (TIMERWHEEL_LEVELS * TIMERWHEEL_SLOT_BITS)) - 1) // farthest a timer can be filed directly
+#define TOP_LEVEL (TIMERWHEEL_LEVELS - 1)
+
+static timerWheel_timer_t *wheel[TIMERWHEEL_LEVELS][SLOTS];
+static uint32_t now; // wheel ticks since init
+static uint64_t nextTickAt; // hardware counter value at which the wheel ticks next
+static timestamp_handle_t hardwareTimer;
+static bool initialized = false;
+
+// helper function that links timer into a slot, picked by how far away it expires
+static void file(timerWheel_timer_t *timer) {
+    uint32_t delta = timer->expires - now;
+    uint8_t level = 0;
+    uint32_t slot;
+    while ((level < TOP_LEVEL) && (delta >> ((level + 1) * TIMERWHEEL_SLOT_BITS))) // the first level whose reach covers delta
+        level++;
+    if (delta > MAX_DELTA) // too far for any level: park it in the top level slot cascaded last, it is filed again from there
+        slot = ((now >> (TOP_LEVEL * TIMERWHEEL_SLOT_BITS)) - 1) & SLOT_MASK;
+    else
+        slot = (timer->expires >> (level * TIMERWHEEL_SLOT_BITS)) & SLOT_MASK;
+    timer->next = wheel[level][slot];
+    if (timer->next)
+        timer->next->pprev = &timer->next;
+    timer->pprev = &wheel[level][slot];
+    wheel[level][slot] = timer;
+}
+
+// helper function that unlinks an armed timer
+static void unlink(timerWheel_timer_t *timer) {
+    *timer->pprev = timer->next;
+    if (timer->next)
+        timer->next->pprev = timer->pprev;
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+// helper function that re-files every timer in one slot of an upper level;
+// they have come close enough for a lower level
+static void cascade(uint8_t level) {
+    timerWheel_timer_t **slot = &wheel[level][(now >> (level * TIMERWHEEL_SLOT_BITS)) & SLOT_MASK];
+    timerWheel_timer_t *timer = *slot;
+    *slot = NULL;
+    while (timer) {
+        timerWheel_timer_t *next = timer->next;
+        file(timer);
+        timer = next;
+    }
+}
+
+// helper function that moves the wheel one tick and fires what is due
+static uint32_t advanceOneTick() {
+    uint32_t fired = 0;
+    now++;
+    for (int8_t level = TOP_LEVEL; level > 0; level--) // at each level boundary pull the next slot down, highest level first
+        if ((now & ((1UL << (level * TIMERWHEEL_SLOT_BITS)) - 1)) == 0)
+            cascade(level);
+    timerWheel_timer_t **slot = &wheel[0][now & SLOT_MASK];
+    while (*slot) { // take one at a time so callbacks can start or cancel anything
+        timerWheel_timer_t *timer = *slot;
+        unlink(timer);
+        fired++;
+        if (timer->callback)
+            timer->callback(timer->context);
+    }
+    return fired;
+}
+
+// Starts the hardware timer the wheel runs on. Calling it again does nothing.
+void timerWheel_init() {
+    if (initialized)
+        return;
+    hardwareTimer = timestamp_startTimer(TIMERWHEEL_TIMER); // may already be running for another module
+    now = 0;
+    nextTickAt = timestamp_read(hardwareTimer) + HARDWARE_TICKS_PER_MS;
+    initialized = true;
+}
+
+// Arms timer to fire ms milliseconds from now (at least one wheel tick),
+// re-arming it if it is already armed. callback may be NULL for timers that
+// are only polled with timerWheel_isArmed.
+void timerWheel_start(timerWheel_timer_t *timer, uint32_t ms, timerWheel_callback_t callback, void *context) {
+    if (timer->pprev)
+        unlink(timer);
+    timer->expires = now + ((ms > 0) ? ms : 1); // never the slot being fired right now
+    timer->callback = callback;
+    timer->context = context;
+    file(timer);
+}
+
+// Disarms timer without calling its callback. Harmless if it isn't armed.
+void timerWheel_cancel(timerWheel_timer_t *timer) {
+    if (timer->pprev)
+        unlink(timer);
+}
+
+// Returns true from timerWheel_start until the timer fires or is cancelled.
+bool timerWheel_isArmed(const timerWheel_timer_t *timer) {
+    return timer->pprev != NULL;
+}
+
+// Advances the wheel to the hardware time and fires every timer that is due.
+// A callback may start or cancel timers, including its own.
+// Returns the number of timers fired.
+uint32_t timerWheel_update() {
+    uint32_t fired = 0;
+    uint64_t hardwareNow = timestamp_read(hardwareTimer);
+    while (hardwareNow >= nextTickAt) { // one pass per millisecond since the last update
+        fired += advanceOneTick();
+        nextTickAt += HARDWARE_TICKS_PER_MS;
+    }
+    return fired;
+}
+
+// Returns the wheel time in milliseconds since timerWheel_init.
+uint32_t timerWheel_now() {
+    return now;
+}
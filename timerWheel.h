@@ -0,0 +1,56 @@
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Many software timers on one AXI interval timer. Time is kept in 1 ms wheel
+// ticks read from the hardware counter, and armed timers sit in a three
+// level hierarchical wheel (64 slots per level: 64 ms, 4 s and 4 min of
+// reach, longer timers are re-filed as they come closer). Starting and
+// cancelling a timer is O(1), and advancing one wheel tick touches one slot
+// plus, every 64 ticks, one slot of the level above, so the cost of an
+// update does not grow with the number of armed timers.
+//
+// Everything runs in the caller's context: expiry callbacks are made from
+// timerWheel_update, which the tick functions call, never from an interrupt.
+
+#define TIMERWHEEL_TIMER INTERVAL_TIMER_TIMER_1
+#define TIMERWHEEL_LEVELS 3
+#define TIMERWHEEL_SLOT_BITS 6 // 64 slots per level
+
+typedef void (*timerWheel_callback_t)(void *context);
+
+// One software timer. The caller owns the storage (normally a static);
+// the fields are private to the wheel.
+typedef struct timerWheel_timer {
+    struct timerWheel_timer *next;
+    struct timerWheel_timer **pprev; // the pointer that points at this timer, NULL when not armed
+    uint32_t expires; // wheel tick at which it fires
+    timerWheel_callback_t callback;
+    void *context;
+} timerWheel_timer_t;
+
+// Starts the hardware timer the wheel runs on. Calling it again does nothing.
+void timerWheel_init();
+
+// Arms timer to fire ms milliseconds from now (at least one wheel tick),
+// re-arming it if it is already armed. callback may be NULL for timers that
+// are only polled with timerWheel_isArmed.
+void timerWheel_start(timerWheel_timer_t *timer, uint32_t ms, timerWheel_callback_t callback, void *context);
+
+// Disarms timer without calling its callback. Harmless if it isn't armed.
+void timerWheel_cancel(timerWheel_timer_t *timer);
+
+// Returns true from timerWheel_start until the timer fires or is cancelled.
+bool timerWheel_isArmed(const timerWheel_timer_t *timer);
+
+// Advances the wheel to the hardware time and fires every timer that is due.
+// A callback may start or cancel timers, including its own.
+// Returns the number of timers fired.
+uint32_t timerWheel_update();
+
+// Returns the wheel time in milliseconds since timerWheel_init.
+uint32_t timerWheel_now();
+
+#endif /* TIMERWHEEL_H_ */
@@ -0,0 +1,34 @@
+#include "timestamp.h"
+#include "intervalTimer.h"
+
+#include <stdbool.h>
+
+#define NUM_OF_TIMERS 3
+
+static const timestamp_handle_t handles[NUM_OF_TIMERS] = {
+    [INTERVAL_TIMER_TIMER_0] = XPAR_AXI_TIMER_0_BASEADDR,
+    [INTERVAL_TIMER_TIMER_1] = XPAR_AXI_TIMER_1_BASEADDR,
+    [INTERVAL_TIMER_TIMER_2] = XPAR_AXI_TIMER_2_BASEADDR
+};
+
+// Returns the handle for one of the three interval timers, or 0 for an
+// invalid timer number. Look it up once, outside the hot path.
+timestamp_handle_t timestamp_getHandle(uint32_t timerNumber) {
+    if (timerNumber >= NUM_OF_TIMERS)
+        return 0;
+    return handles[timerNumber];
+}
+
+// Sets up and starts timerNumber as a free-running counter the first time it
+// is called for that timer; later calls leave it running, so several modules
+// can share one time base. Returns the timer's handle.
+timestamp_handle_t timestamp_startTimer(uint32_t timerNumber) {
+    static bool running[NUM_OF_TIMERS];
+    if ((timerNumber < NUM_OF_TIMERS) && !running[timerNumber]) {
+        intervalTimer_init(timerNumber);
+        intervalTimer_reset(timerNumber);
+        intervalTimer_start(timerNumber);
+        running[timerNumber] = true;
+    }
+    return timestamp_getHandle(timerNumber);
+}
@@ -0,0 +1,68 @@
+#ifndef TIMESTAMP_H_
+#define TIMESTAMP_H_
+
+#include "xil_io.h"
+#include "xparameters.h"
+
+#include <stdint.h>
+
+// Integer timestamps from the 64 bit cascaded AXI interval timers. A handle
+// is looked up once per timer; after that a read is just the register reads
+// and conversions are a multiply and a shift, with no double math.
+//
+// The timer must have been set up with intervalTimer_init and started.
+
+#define TIMESTAMP_TCR0_OFFSET 0x08
+#define TIMESTAMP_TCR1_OFFSET 0x18
+#define TIMESTAMP_TIMER_WIDTH 32
+#define TIMESTAMP_TICKS_PER_SECOND XPAR_AXI_TIMER_0_CLOCK_FREQ_HZ
+
+// Fixed-point conversion factors: units = ticks * MULTIPLIER >> SHIFT. The
+// shifts keep the multipliers under 32 bits for clocks of 1 MHz and up.
+#define TIMESTAMP_NS_SHIFT 24
+#define TIMESTAMP_US_SHIFT 32
+#define TIMESTAMP_NS_MULTIPLIER (((1000000000ULL << TIMESTAMP_NS_SHIFT) + TIMESTAMP_TICKS_PER_SECOND / 2) / TIMESTAMP_TICKS_PER_SECOND)
+#define TIMESTAMP_US_MULTIPLIER (((1000000ULL << TIMESTAMP_US_SHIFT) + TIMESTAMP_TICKS_PER_SECOND / 2) / TIMESTAMP_TICKS_PER_SECOND)
+
+// the timer's base address
+typedef uint32_t timestamp_handle_t;
+
+// Returns the handle for one of the three interval timers, or 0 for an
+// invalid timer number. Look it up once, outside the hot path.
+timestamp_handle_t timestamp_getHandle(uint32_t timerNumber);
+
+// Sets up and starts timerNumber as a free-running counter the first time it
+// is called for that timer; later calls leave it running, so several modules
+// can share one time base. Returns the timer's handle.
+timestamp_handle_t timestamp_startTimer(uint32_t timerNumber);
+
+// Returns the counter in ticks. The upper word is read before and after the
+// lower word; if a carry came in between, the lower word is read again so
+// the two halves always belong together.
+static inline uint64_t timestamp_read(timestamp_handle_t timer) {
+    uint32_t upper = Xil_In32(timer + TIMESTAMP_TCR1_OFFSET);
+    uint32_t lower = Xil_In32(timer + TIMESTAMP_TCR0_OFFSET);
+    uint32_t upperAgain = Xil_In32(timer + TIMESTAMP_TCR1_OFFSET);
+    if (upper != upperAgain)
+        lower = Xil_In32(timer + TIMESTAMP_TCR0_OFFSET);
+    return ((uint64_t) upperAgain << TIMESTAMP_TIMER_WIDTH) | lower;
+}
+
+// helper for the conversions: ticks * multiplier >> shift without overflowing
+// 64 bits, by scaling the two 32 bit halves of ticks separately
+static inline uint64_t timestamp_scale(uint64_t ticks, uint64_t multiplier, uint8_t shift) {
+    uint64_t upper = (ticks >> TIMESTAMP_TIMER_WIDTH) * multiplier;
+    uint64_t lower = (ticks & UINT32_MAX) * multiplier;
+    return (upper << (TIMESTAMP_TIMER_WIDTH - shift)) + (lower >> shift);
+}
+
+// Converts ticks to nanoseconds or microseconds.
+static inline uint64_t timestamp_toNanoseconds(uint64_t ticks) {
+    return timestamp_scale(ticks, TIMESTAMP_NS_MULTIPLIER, TIMESTAMP_NS_SHIFT);
+}
+
+static inline uint64_t timestamp_toMicroseconds(uint64_t ticks) {
+    return timestamp_scale(ticks, TIMESTAMP_US_MULTIPLIER, TIMESTAMP_US_SHIFT);
+}
+
+#endif /* TIMESTAMP_H_ */
@@ -0,0 +1,177 @@
+#include "touchInput.h"
+#include "intervalTimer.h"
+#include "timestamp.h"
+
+#include <display.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TICKS_PER_SAMPLE ((uint32_t) (TIMESTAMP_TICKS_PER_SECOND / 1000 * TOUCHINPUT_SAMPLE_MS))
+
+static timestamp_handle_t timer;
+static uint64_t lastSampleTicks;
+static uint64_t touchStartTicks;
+static bool touched; // as of the last sample
+static bool settled;
+static bool abandoned;
+static bool locked; // cleared while still pressed: ignore the rest of this touch
+static int16_t xs[TOUCHINPUT_RING_SIZE];
+static int16_t ys[TOUCHINPUT_RING_SIZE];
+static uint8_t ringHead; // slot the next sample goes in
+static uint8_t sampleCount; // valid samples in the ring, stops at TOUCHINPUT_RING_SIZE
+static int16_t pointX, pointY;
+
+static uint32_t touches;
+static uint32_t settledCount;
+static uint32_t tapCount; // settled on release
+static uint32_t abandonedCount;
+static uint32_t rejectedCount;
+static uint64_t totalSettleTicks;
+static uint32_t worstSettleTicks;
+
+// helper function that returns the ring slot of the newest sample but age
+static uint8_t newest(uint8_t age) {
+    return (ringHead + TOUCHINPUT_RING_SIZE - 1 - age) % TOUCHINPUT_RING_SIZE;
+}
+
+// helper function that returns the median of the n newest values in ring
+static int16_t median(const int16_t *ring, uint8_t n) {
+    int16_t sorted[TOUCHINPUT_RING_SIZE];
+    for (uint8_t i = 0; i < n; i++) { // insertion sort, n is tiny
+        int16_t value = ring[newest(i)];
+        uint8_t j = i;
+        for (; (j > 0) && (sorted[j - 1] > value); j--)
+            sorted[j] = sorted[j - 1];
+        sorted[j] = value;
+    }
+    return sorted[n / 2];
+}
+
+// helper function that returns true if the newest TOUCHINPUT_STABLE_SAMPLES
+// samples are all within TOUCHINPUT_STABLE_RADIUS of their median (x, y)
+static bool newestAgree(int16_t x, int16_t y) {
+    for (uint8_t i = 0; i < TOUCHINPUT_STABLE_SAMPLES; i++) {
+        uint8_t index = newest(i);
+        if ((abs(xs[index] - x) > TOUCHINPUT_STABLE_RADIUS) || (abs(ys[index] - y) > TOUCHINPUT_STABLE_RADIUS))
+            return false;
+    }
+    return true;
+}
+
+// helper function that settles the touch at the median of the n newest samples
+static void settle(uint64_t now, uint8_t n) {
+    pointX = median(xs, n);
+    pointY = median(ys, n);
+    settled = true;
+    settledCount++;
+    uint32_t settleTicks = now - touchStartTicks;
+    totalSettleTicks += settleTicks;
+    if (settleTicks > worstSettleTicks)
+        worstSettleTicks = settleTicks;
+}
+
+// helper function that takes one reading from the touch controller
+static void sample(uint64_t now) {
+    int16_t x, y;
+    uint8_t z;
+    display_getTouchedPoint(&x, &y, &z);
+    if ((z < TOUCHINPUT_MIN_Z) || (x < 0) || (x >= DISPLAY_WIDTH) || (y < 0) || (y >= DISPLAY_HEIGHT)) {
+        rejectedCount++;
+        return;
+    }
+    xs[ringHead] = x;
+    ys[ringHead] = y;
+    ringHead = (ringHead + 1) % TOUCHINPUT_RING_SIZE;
+    if (sampleCount < TOUCHINPUT_RING_SIZE) // a touch held for minutes must not wrap the count
+        sampleCount++;
+    if (settled) { // held: follow the finger
+        pointX = median(xs, sampleCount);
+        pointY = median(ys, sampleCount);
+    }
+    else if ((sampleCount >= TOUCHINPUT_STABLE_SAMPLES) && newestAgree(median(xs, TOUCHINPUT_STABLE_SAMPLES), median(ys, TOUCHINPUT_STABLE_SAMPLES)))
+        settle(now, TOUCHINPUT_STABLE_SAMPLES); // the older samples were taken while the reading still moved
+}
+
+// Forgets any touch in progress and starts the time base.
+void touchInput_init() {
+    timer = timestamp_startTimer(TOUCHINPUT_TIMER);
+    lastSampleTicks = timestamp_read(timer);
+    touched = false;
+    settled = false;
+    abandoned = false;
+    locked = false;
+    sampleCount = 0;
+}
+
+// Takes a sample if TOUCHINPUT_SAMPLE_MS have passed since the last one.
+void touchInput_update() {
+    uint64_t now = timestamp_read(timer);
+    if (now - lastSampleTicks < TICKS_PER_SAMPLE)
+        return;
+    lastSampleTicks = now;
+
+    if (!display_isTouched()) {
+        if (touched && !settled && !locked) { // let go before settling: a tap, if there is anything to go on
+            if (sampleCount) {
+                settle(now, sampleCount);
+                tapCount++;
+            }
+            else {
+                abandoned = true;
+                abandonedCount++;
+            }
+        }
+        touched = false;
+        locked = false;
+        return;
+    }
+
+    if (!touched) { // a new touch; the first reading comes on the next sample
+        touched = true;
+        settled = false;
+        abandoned = false;
+        sampleCount = 0;
+        touchStartTicks = now;
+        touches++;
+        display_clearOldTouchData(); // the controller may still hold readings from the last touch
+        return;
+    }
+    if (!locked)
+        sample(now);
+}
+
+// Returns true while the panel is pressed.
+bool touchInput_isTouched() {
+    return touched;
+}
+
+// Returns true once the current (or just released) touch has a stable point.
+bool touchInput_isSettled() {
+    return settled;
+}
+
+// Returns true if a touch let go without giving a single valid sample.
+bool touchInput_isAbandoned() {
+    return abandoned;
+}
+
+// The settled point.
+void touchInput_getPoint(int16_t *x, int16_t *y) {
+    *x = pointX;
+    *y = pointY;
+}
+
+// Done with the point: the next one comes from a new touch.
+void touchInput_clear() {
+    settled = false;
+    abandoned = false;
+    locked = touched;
+}
+
+// Prints touches, settled points, rejected samples and touch-to-settle time.
+void touchInput_printStats() {
+    uint32_t averageUs = settledCount ? timestamp_toMicroseconds(totalSettleTicks / settledCount) : 0;
+    printf("touchInput: %lu touches, %lu settled (%lu on release), %lu abandoned, %lu samples rejected, settle average %lu us worst %lu us\n", (unsigned long) touches,
+           (unsigned long) settledCount, (unsigned long) tapCount, (unsigned long) abandonedCount, (unsigned long) rejectedCount, (unsigned long) averageUs,
+           (unsigned long) timestamp_toMicroseconds(worstSettleTicks));
+}
@@ -0,0 +1,54 @@
+#ifndef TOUCHINPUT_H_
+#define TOUCHINPUT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Filtered touch input. touchInput_update samples the touch controller at
+// most every TOUCHINPUT_SAMPLE_MS; samples with too little pressure (z) or
+// off the panel are thrown away, the rest go into a small ring. As soon as
+// the last TOUCHINPUT_STABLE_SAMPLES samples all lie within
+// TOUCHINPUT_STABLE_RADIUS of the median of the ring, the touch is settled
+// and its point is the median. That replaces waiting a fixed worst-case ADC
+// settle time and then trusting a single sample.
+//
+// A touch that lets go before it settles is settled on release from
+// whatever valid samples it had (a quick tap); with none it is dropped.
+//
+// Consumers look at touchInput_isSettled and, once they have used the
+// point, call touchInput_clear; the next point then comes from a new touch.
+
+#define TOUCHINPUT_SAMPLE_MS 10 // samples closer together than this are skipped
+#define TOUCHINPUT_RING_SIZE 5 // samples the point follows while the touch is held
+#define TOUCHINPUT_STABLE_SAMPLES 3 // the newest samples that must agree with the median
+#define TOUCHINPUT_STABLE_RADIUS 3 // pixels, in x and in y
+#define TOUCHINPUT_MIN_Z 10 // lighter presses are not trusted
+#define TOUCHINPUT_TIMER INTERVAL_TIMER_TIMER_1 // only read, shared with the timer wheel and the scheduler
+
+// Forgets any touch in progress and starts the time base.
+void touchInput_init();
+
+// Takes a sample if TOUCHINPUT_SAMPLE_MS have passed since the last one.
+// Call once per tick or loop pass.
+void touchInput_update();
+
+// Returns true while the panel is pressed, as of the last sample.
+bool touchInput_isTouched();
+
+// Returns true once the current (or just released) touch has a stable point.
+bool touchInput_isSettled();
+
+// Returns true if a touch let go without giving a single valid sample, so
+// no point will come from it.
+bool touchInput_isAbandoned();
+
+// The settled point; while the touch is held it follows the median.
+void touchInput_getPoint(int16_t *x, int16_t *y);
+
+// Done with the point: the next one comes from a new touch.
+void touchInput_clear();
+
+// Prints touches, settled points, rejected samples and touch-to-settle time.
+void touchInput_printStats();
+
+#endif /* TOUCHINPUT_H_ */